@@ -0,0 +1,47 @@
+/*****************************************************************************
+* SST host-side benchmark helpers
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#ifndef bench_h
+#define bench_h
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t bench_now(void) {             /* TSC reference ticks */
+    return (uint64_t)__rdtsc();
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t bench_now(void) {       /* monotonic nanoseconds */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+static inline uint64_t bench_ns(void) {   /* wall time for rates/second */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t bench_rand(uint32_t *state) {      /* xorshift32 */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+#endif                                                           /* bench_h */
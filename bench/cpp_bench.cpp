@@ -0,0 +1,108 @@
+/*****************************************************************************
+* SST benchmark: C++ front end against the hand-written C task
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst.hpp"
+#include "cpp_bench.h"
+#include "bench.h"
+
+#define N_EVENTS  100000U
+#define N_ROUNDS  20U
+#define C_PRIO    2U
+#define CPP_PRIO  3U
+
+extern "C" void SST_start(void) {
+}
+extern "C" void SST_onIdle(void) {
+}
+
+namespace {
+
+using Init = sst::Signal<INIT_SIG>;
+using Add  = sst::Signal<SIG_ADD, uint8_t>;
+using Xor  = sst::Signal<SIG_XOR, uint8_t>;
+using Sub  = sst::Signal<SIG_SUB, uint8_t>;
+using Mul  = sst::Signal<SIG_MUL, uint8_t>;
+using Set  = sst::Signal<SIG_SET, uint8_t>;
+using Clr  = sst::Signal<SIG_CLR>;
+
+inline void onAdd(uint8_t x) { l_acc += x; }
+inline void onXor(uint8_t x) { l_acc ^= x; }
+inline void onSub(uint8_t x) { l_acc -= x; }
+inline void onMul(uint8_t x) { l_acc *= static_cast<uint32_t>(x) | 1U; }
+inline void onSet(uint8_t x) { l_acc = x; }
+inline void onClr() { l_acc = 0U; }
+
+using CppTask = sst::Task<CPP_PRIO, sst::On<Add, &onAdd>, sst::On<Xor, &onXor>,
+                          sst::On<Sub, &onSub>, sst::On<Mul, &onMul>,
+                          sst::On<Set, &onSet>, sst::On<Clr, &onClr>>;
+
+SSTEvent l_cQueue[1];
+SSTEvent l_cppQueue[1];
+SSTEvent l_sigs[N_EVENTS];                 /* the same events for both */
+
+} // namespace
+
+/* CppTask::dispatch() inlined into a section of its own, to measure it */
+extern "C" __attribute__((section("sst_cpptask"), flatten))
+void cppTask(SSTEvent e) {
+    CppTask::dispatch(e);
+}
+extern "C" char const __start_sst_cpptask[];
+extern "C" char const __stop_sst_cpptask[];
+
+/*..........................................................................*/
+template <typename Post>
+static double perEvent(Post post) {       /* best of N_ROUNDS, per event */
+    uint64_t best = ~static_cast<uint64_t>(0);
+    for (uint32_t r = 0U; r < N_ROUNDS; ++r) {
+        uint64_t t = bench_now();
+        for (uint32_t i = 0U; i < N_EVENTS; ++i) {
+            post(l_sigs[i]);
+        }
+        t = bench_now() - t;
+        if (t < best) {
+            best = t;
+        }
+    }
+    return static_cast<double>(best) / N_EVENTS;
+}
+/*..........................................................................*/
+int main() {
+    uint32_t seed = 1U;
+    for (uint32_t i = 0U; i < N_EVENTS; ++i) {  /* SIG_ADD..SIG_END mixed */
+        uint32_t r = bench_rand(&seed);
+        l_sigs[i].sig = static_cast<SSTSignal>(SIG_ADD
+                                               + r % (SIG_END - SIG_ADD + 1));
+        l_sigs[i].par = static_cast<SSTParam>(r >> 8);
+    }
+    SST_task(&cTask, C_PRIO, l_cQueue, 1, INIT_SIG, 0);
+    CppTask::start<Init>(l_cppQueue);
+    SST_run();
+
+    printf("C++ front end against the hand-written C task (%s per event)\n",
+           BENCH_UNIT);
+    printf("%-34s %8s %8s\n", "", "C", "C++");
+    printf("%-34s %8.1f %8.1f\n", "dispatch, direct call",
+           perEvent([](SSTEvent e) { cTask(e); }),
+           perEvent([](SSTEvent e) { cppTask(e); }));
+    printf("%-34s %8.1f %8.1f\n", "SST_post + dispatch",
+           perEvent([](SSTEvent e) { SST_post(C_PRIO, e.sig, e.par); }),
+           perEvent([](SSTEvent e) {
+               SST_post(CPP_PRIO, e.sig, e.par);
+           }));
+    printf("%-34s %8.1f %8.1f\n", "SST_post + dispatch, SIG_ADD",
+           perEvent([](SSTEvent e) { SST_post(C_PRIO, SIG_ADD, e.par); }),
+           perEvent([](SSTEvent e) { CppTask::post<Add>(e.par); }));
+    printf("%-34s %8u %8u\n", "dispatch code, bytes",
+           static_cast<unsigned>(__stop_sst_ctask - __start_sst_ctask),
+           static_cast<unsigned>(__stop_sst_cpptask - __start_sst_cpptask));
+    return 0;
+}
@@ -0,0 +1,39 @@
+/*****************************************************************************
+* SST benchmark: C++ front end against the hand-written C task
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#ifndef cpp_bench_h
+#define cpp_bench_h
+
+#include "sst_exa.h"
+
+enum BenchSignals {                  /* handled by both benchmark tasks */
+    SIG_ADD = COLOR_SIG + 1,
+    SIG_XOR,
+    SIG_SUB,
+    SIG_MUL,
+    SIG_SET,
+    SIG_CLR,
+    SIG_END                                         /* unhandled, ignored */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile uint32_t l_acc;              /* state of both tasks */
+void cTask(SSTEvent e);                  /* in its own section, sst_ctask */
+extern char const __start_sst_ctask[];         /* defined by the linker */
+extern char const __stop_sst_ctask[];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* cpp_bench_h */
@@ -0,0 +1,36 @@
+/*****************************************************************************
+* SST benchmark: the hand-written C task of cpp_bench
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "cpp_bench.h"
+
+volatile uint32_t l_acc;
+
+__attribute__((section("sst_ctask")))
+void cTask(SSTEvent e) {                  /* in the style of task_A..task_D */
+    if (e.sig == SIG_ADD) {
+        l_acc += e.par;
+    }
+    else if (e.sig == SIG_XOR) {
+        l_acc ^= e.par;
+    }
+    else if (e.sig == SIG_SUB) {
+        l_acc -= e.par;
+    }
+    else if (e.sig == SIG_MUL) {
+        l_acc *= (uint32_t)e.par | 1U;
+    }
+    else if (e.sig == SIG_SET) {
+        l_acc = e.par;
+    }
+    else if (e.sig == SIG_CLR) {
+        l_acc = 0U;
+    }
+}
@@ -0,0 +1,360 @@
+/*****************************************************************************
+* SST stress test: dynamic events against a reference model
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#ifndef SST_DYN_POOLS
+#error "dyn_bench needs SST_DYN_POOLS"
+#endif
+
+#define N_ROUNDS    50000U
+#define N_TASKS     3U
+#define QUEUE_LEN   3U
+#define N_SMALL     4U                  /* blocks in the 8-byte pool */
+#define N_LARGE     3U                  /* blocks in the 16-byte pool */
+#define N_BLOCKS    (N_SMALL + N_LARGE)
+#define MAX_OPS     12U
+#define CEIL_PRIO   (N_TASKS + 1U)   /* holds the tasks while posting */
+#define NO_BLK      0xFFU
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Every round gives each of three tasks a queue of QUEUE_LEN events
+  and a random overflow policy, and while a mutex ceiling holds them mixes
+  new and already queued dynamic events, posted to one task or multicast
+  to a random set, with static events. The queues fill up, so the policies
+  drop, overwrite and coalesce dynamic events too. A model keeps each
+  queue and the references of each block: after every post the result
+  and every refCtr__ must match it, and the pools must hold exactly the
+  blocks it calls live. Then the tasks run, each copy must still count
+  itself and the copies not run yet, and afterwards both pools must be
+  back to all their blocks free.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+typedef struct {
+    SSTDynEvt super;
+    uint8_t id;                                 /* the model's block index */
+} BlkEvt;
+
+typedef struct {
+    SSTSignal sig;
+    uint8_t blk;                                     /* NO_BLK for static */
+} RefEvt;
+
+static SSTEvent l_queue[N_TASKS + 1U][QUEUE_LEN];
+static void *l_small[N_SMALL * 8U / sizeof(void *)];
+static void *l_large[N_LARGE * 16U / sizeof(void *)];
+static RefEvt l_ref[N_TASKS + 1U][QUEUE_LEN];  /* the model, per priority */
+static uint8_t l_nRef[N_TASKS + 1U];
+static uint8_t l_policy[N_TASKS + 1U];
+static BlkEvt *l_blk[N_BLOCKS];               /* NULL when not allocated */
+static uint8_t l_blkPool[N_BLOCKS];
+static uint8_t l_refs[N_BLOCKS];          /* queued copies of each block */
+static uint16_t l_got[N_TASKS * QUEUE_LEN];         /* what the tasks ran */
+static uint8_t l_nGot;
+static uint32_t l_errors;
+static uint32_t l_drops;
+static uint32_t l_seed = 1U;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void task(SSTEvent e) {
+    uint8_t blk = NO_BLK;
+    if (e.sig == INIT_SIG) {
+        return;
+    }
+    if (e.dyn != (SSTDynEvt *)0) {
+        blk = ((BlkEvt *)e.dyn)->id;
+        if (e.dyn->refCtr__ != l_refs[blk]) {  /* this copy and those left */
+            ++l_errors;
+        }
+        --l_refs[blk];
+    }
+    l_got[l_nGot++] = (uint16_t)(e.sig * 100U + (uint8_t)(blk + 1U));
+}
+static uint8_t liveIn(uint8_t pool) {
+    uint8_t n = 0;
+    uint8_t b;
+    for (b = 0; b < N_BLOCKS; ++b) {
+        if ((l_blk[b] != (BlkEvt *)0) && (l_blkPool[b] == pool)) {
+            ++n;
+        }
+    }
+    return n;
+}
+static void modelRelease(uint8_t b) {
+    if (--l_refs[b] == 0U) {
+        l_blk[b] = (BlkEvt *)0;                 /* back in the pool */
+    }
+}
+/* the queue handling of enqueue_(), one queued copy per reference */
+static uint8_t modelPost(uint8_t p, SSTSignal sig, uint8_t b) {
+    RefEvt *r = l_ref[p];
+    uint8_t i = NO_BLK;
+    uint8_t lost;
+    if (l_nRef[p] < QUEUE_LEN) {
+        r[l_nRef[p]].sig = sig;
+        r[l_nRef[p]].blk = b;
+        ++l_nRef[p];
+        if (b != NO_BLK) {
+            ++l_refs[b];
+        }
+        return 1U;
+    }
+    switch (l_policy[p]) {
+        case SST_OVF_DROP_OLDEST:
+            i = 0U;
+            break;
+        case SST_OVF_OVERWRITE_LATEST:
+            i = (uint8_t)(l_nRef[p] - 1U);
+            break;
+        case SST_OVF_COALESCE:
+            for (i = l_nRef[p]; (i-- != 0U) && (r[i].sig != sig); ) {
+            }
+            break;
+        default:
+            break;
+    }
+    if (i == NO_BLK) {
+        return 0U;
+    }
+    ++l_drops;
+    lost = r[i].blk;
+    if (lost != b) {             /* the same block keeps its one reference */
+        if (lost != NO_BLK) {
+            modelRelease(lost);
+        }
+        if (b != NO_BLK) {
+            ++l_refs[b];
+        }
+    }
+    if (l_policy[p] == SST_OVF_DROP_OLDEST) {
+        memmove(&r[0], &r[1], (QUEUE_LEN - 1U) * sizeof(r[0]));
+        i = (uint8_t)(QUEUE_LEN - 1U);
+    }
+    r[i].sig = sig;
+    r[i].blk = b;
+    return 1U;
+}
+static uint8_t modelMulticast(SSTPrioSet const *prios, SSTSignal sig,
+                              uint8_t b)
+{
+    uint8_t n = 0;
+    uint8_t p;
+    for (p = N_TASKS; p != 0U; --p) {         /* the kernel goes top down */
+        if (SST_prioSetHas(prios, p) && modelPost(p, sig, b)) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+/*..........................................................................*/
+static uint8_t newBlock(uint8_t *b) {
+    uint8_t pool = (uint8_t)(1U + bench_rand(&l_seed) % 2U);
+    uint8_t i;
+    BlkEvt *e = (BlkEvt *)SST_dynNew((pool == 1U) ? (uint16_t)sizeof(BlkEvt)
+                                                  : (uint16_t)12U);
+    uint8_t full = (uint8_t)(liveIn(pool)
+                             == ((pool == 1U) ? N_SMALL : N_LARGE));
+    if ((e == (BlkEvt *)0) != full) {
+        printf("SST_dynNew() gave %p from pool %u with %u blocks live\n",
+               (void *)e, (unsigned)pool, (unsigned)liveIn(pool));
+        ++l_errors;
+    }
+    if (e == (BlkEvt *)0) {
+        return 0U;
+    }
+    for (i = 0; l_blk[i] != (BlkEvt *)0; ++i) {
+    }
+    l_blk[i] = e;
+    l_blkPool[i] = pool;
+    l_refs[i] = 0U;
+    e->id = i;
+    *b = i;
+    return 1U;
+}
+static uint8_t oldBlock(uint8_t *b) {
+    uint8_t i = (uint8_t)(bench_rand(&l_seed) % N_BLOCKS);
+    uint8_t n;
+    for (n = 0; n < N_BLOCKS; ++n, i = (uint8_t)((i + 1U) % N_BLOCKS)) {
+        if (l_blk[i] != (BlkEvt *)0) {
+            *b = i;
+            return 1U;
+        }
+    }
+    return 0U;
+}
+static uint8_t check(uint32_t n, uint8_t op) {
+    uint8_t b;
+    for (b = 0; b < N_BLOCKS; ++b) {
+        if ((l_blk[b] != (BlkEvt *)0)
+            && (l_blk[b]->super.refCtr__ != l_refs[b]))
+        {
+            printf("round %u, op %u: block %u has refCtr %u, model %u\n",
+                   (unsigned)n, (unsigned)op, (unsigned)b,
+                   (unsigned)l_blk[b]->super.refCtr__, (unsigned)l_refs[b]);
+            return 0U;
+        }
+    }
+    if ((SST_dynPoolUsed(1U) != liveIn(1U))
+        || (SST_dynPoolUsed(2U) != liveIn(2U)))
+    {
+        printf("round %u, op %u: pools use %u+%u blocks, model %u+%u\n",
+               (unsigned)n, (unsigned)op,
+               (unsigned)SST_dynPoolUsed(1U), (unsigned)SST_dynPoolUsed(2U),
+               (unsigned)liveIn(1U), (unsigned)liveIn(2U));
+        return 0U;
+    }
+    return 1U;
+}
+/*..........................................................................*/
+static uint8_t op_(uint32_t n, uint8_t i) {
+    uint8_t kind = (uint8_t)(bench_rand(&l_seed) % 5U);
+    uint8_t p = (uint8_t)(1U + bench_rand(&l_seed) % N_TASKS);
+    SSTSignal sig = (SSTSignal)(1U + bench_rand(&l_seed) % 3U);
+    SSTPrioSet prios;
+    uint8_t ok = 0U;
+    uint8_t exp = 0U;
+    uint8_t b = NO_BLK;
+    uint8_t q;
+
+    SST_prioSetClear(&prios);
+    for (q = 1U; q <= N_TASKS; ++q) {
+        if ((bench_rand(&l_seed) & 1U) != 0U) {
+            SST_prioSetInsert(&prios, q);
+        }
+    }
+    switch (kind) {
+        case 0U:                                       /* a new event */
+        case 1U:
+            if (!newBlock(&b)) {
+                return 1U;
+            }
+            break;
+        case 2U:                                    /* a queued event */
+        case 3U:
+            if (!oldBlock(&b)) {
+                return 1U;
+            }
+            break;
+        default:                                     /* a static event */
+            ok = SST_post(p, sig, 0);
+            exp = modelPost(p, sig, NO_BLK);
+            break;
+    }
+    if (b != NO_BLK) {
+        if ((kind & 1U) == 0U) {
+            ok = SST_postDyn(p, sig, &l_blk[b]->super);
+            exp = modelPost(p, sig, b);
+            if (!ok && (l_refs[b] == 0U)) {  /* never posted: the producer's */
+                SST_dynGc(&l_blk[b]->super);
+                l_blk[b] = (BlkEvt *)0;
+            }
+        }
+        else {
+            ok = SST_multicastDyn(&prios, sig, &l_blk[b]->super);
+            exp = modelMulticast(&prios, sig, b);
+            if (l_refs[b] == 0U) {             /* recycled by the guard */
+                l_blk[b] = (BlkEvt *)0;
+            }
+        }
+    }
+    if (ok != exp) {
+        printf("round %u, op %u (kind %u): the post gave %u, model %u\n",
+               (unsigned)n, (unsigned)i, (unsigned)kind,
+               (unsigned)ok, (unsigned)exp);
+        return 0U;
+    }
+    return check(n, i);
+}
+static uint8_t round_(uint32_t n) {
+    uint8_t nOps = (uint8_t)(bench_rand(&l_seed) % MAX_OPS);
+    uint16_t exp[N_TASKS * QUEUE_LEN];
+    uint8_t nExp = 0;
+    uint8_t org;
+    uint8_t p;
+    uint8_t i;
+
+    for (p = 1U; p <= N_TASKS; ++p) {
+        SST_task(&task, p, l_queue[p], QUEUE_LEN, INIT_SIG, 0);
+        l_policy[p] = (uint8_t)(bench_rand(&l_seed) % SST_OVF_POLICIES);
+        SST_taskOverflow(p, l_policy[p]);
+        l_nRef[p] = 0U;
+    }
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < nOps; ++i) {
+        if (!op_(n, i)) {
+            SST_mutexUnlock(org);
+            return 0U;
+        }
+    }
+    for (p = N_TASKS; p != 0U; --p) {
+        for (i = 0; i < l_nRef[p]; ++i) {
+            exp[nExp++] = (uint16_t)(l_ref[p][i].sig * 100U
+                                     + (uint8_t)(l_ref[p][i].blk + 1U));
+        }
+    }
+    l_nGot = 0;
+    SST_mutexUnlock(org);             /* the higher priority task runs first */
+
+    if ((l_nGot != nExp)
+        || (memcmp(l_got, exp, nExp * sizeof(exp[0])) != 0))
+    {
+        printf("round %u: the tasks ran other events\n", (unsigned)n);
+        return 0U;
+    }
+    if ((SST_dynPoolUsed(1U) != 0U) || (SST_dynPoolUsed(2U) != 0U)) {
+        printf("round %u: %u+%u blocks not returned\n", (unsigned)n,
+               (unsigned)SST_dynPoolUsed(1U), (unsigned)SST_dynPoolUsed(2U));
+        return 0U;
+    }
+    memset(l_blk, 0, sizeof(l_blk));
+    return 1U;
+}
+
+/*..........................................................................*/
+int main(void) {
+    uint32_t n;
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    if (!SST_dynPoolInit(l_small, sizeof(l_small), 8U)
+        || !SST_dynPoolInit(l_large, sizeof(l_large), 16U)
+        || SST_dynPoolInit(l_large, sizeof(l_large), 16U))
+    {
+        printf("SST_dynPoolInit() does not stop at %u pools\n",
+               (unsigned)SST_DYN_POOLS);
+        return 1;
+    }
+    if ((SST_dynPool(1U)->nTot__ != N_SMALL)
+        || (SST_dynPool(2U)->nTot__ != N_LARGE))
+    {
+        printf("the pools have %u and %u blocks\n",
+               (unsigned)SST_dynPool(1U)->nTot__,
+               (unsigned)SST_dynPool(2U)->nTot__);
+        return 1;
+    }
+    for (n = 0; n < N_ROUNDS; ++n) {
+        if (!round_(n) || (l_errors != 0U)) {
+            printf("MODEL MISMATCH\n");
+            return 1;
+        }
+    }
+    printf("%u rounds, pools of %u and %u blocks: model ok, "
+           "most used %u+%u, dropped %u\n",
+           (unsigned)N_ROUNDS, (unsigned)N_SMALL, (unsigned)N_LARGE,
+           (unsigned)SST_dynPoolMaxUsed(1U), (unsigned)SST_dynPoolMaxUsed(2U),
+           (unsigned)l_drops);
+    return 0;
+}
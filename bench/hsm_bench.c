@@ -0,0 +1,404 @@
+/*****************************************************************************
+* SST benchmark: table-driven HSM against a switch-based hierarchical task
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "sst_hsm.h"
+#include "bench.h"
+
+#define N_EVENTS  100000U
+#define N_ROUNDS  20U
+#define HSM_PRIO  2U
+#define SW_PRIO   3U
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Both tasks run the same machine, a heater controller:
+
+      ON (init IDLE)                   POWER -> OFF, FAULT -> ERROR, TICK
+          IDLE                         START -> BUSY
+          BUSY (init HEATING)          STOP -> IDLE, TICK
+              HEATING                  HOT -> COOLING
+              COOLING                  COLD -> HEATING, ACK -> COOLING
+          ERROR (init ALARM)           RESET -> ON
+              ALARM                    ACK -> MUTED
+              MUTED                    FAULT -> ALARM
+      OFF                              POWER -> ON
+
+  Every entry, exit and transition action hashes itself into a checksum,
+  which therefore matches only if both tasks ran the same actions in the
+  same order. The switch-based task is written the usual way: a switch per
+  state that falls back to the superstate, and the exits and entries of a
+  transition worked out when it is taken.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+enum HsmStates {
+    S_ON,
+    S_IDLE,
+    S_BUSY,
+    S_HEATING,
+    S_COOLING,
+    S_ERROR,
+    S_ALARM,
+    S_MUTED,
+    S_OFF,
+    N_STATES
+};
+
+enum HsmSignals {
+    SIG_START = COLOR_SIG + 1,
+    SIG_STOP,
+    SIG_HOT,
+    SIG_COLD,
+    SIG_FAULT,
+    SIG_ACK,
+    SIG_RESET,
+    SIG_POWER,
+    SIG_TICK,
+    SIG_END                                         /* unhandled, ignored */
+};
+
+static uint32_t l_sum;                  /* checksum of the actions run */
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void mix_(uint32_t code, SSTEvent const *e) {
+    l_sum = (l_sum ^ (code << 8) ^ (uint32_t)e->par) * 16777619U;
+}
+#define ENTRY_(s_)  (0x100U + (s_))
+#define EXIT_(s_)   (0x200U + (s_))
+#define ACT_(n_)    (0x300U + (n_))
+
+/* the table-driven task ...................................................*/
+#define STATE_ACTIONS_(s_) \
+    static void s_##_entry(void *ctx, SSTEvent const *e) { \
+        (void)ctx; \
+        mix_(ENTRY_(s_), e); \
+    } \
+    static void s_##_exit(void *ctx, SSTEvent const *e) { \
+        (void)ctx; \
+        mix_(EXIT_(s_), e); \
+    }
+#define TRAN_ACTION_(n_) \
+    static void act##n_(void *ctx, SSTEvent const *e) { \
+        (void)ctx; \
+        mix_(ACT_(n_), e); \
+    }
+
+STATE_ACTIONS_(S_ON)
+STATE_ACTIONS_(S_IDLE)
+STATE_ACTIONS_(S_BUSY)
+STATE_ACTIONS_(S_HEATING)
+STATE_ACTIONS_(S_COOLING)
+STATE_ACTIONS_(S_ERROR)
+STATE_ACTIONS_(S_ALARM)
+STATE_ACTIONS_(S_MUTED)
+STATE_ACTIONS_(S_OFF)
+TRAN_ACTION_(1)
+TRAN_ACTION_(2)
+TRAN_ACTION_(3)
+TRAN_ACTION_(4)
+TRAN_ACTION_(5)
+TRAN_ACTION_(6)
+
+#define STATE_(s_, super_, init_) \
+    [s_] = { (super_), (init_), &s_##_entry, &s_##_exit }
+
+static SSTHsmState const l_states[N_STATES] = {
+    STATE_(S_ON,      SST_HSM_NONE, S_IDLE),
+    STATE_(S_IDLE,    S_ON,         SST_HSM_NONE),
+    STATE_(S_BUSY,    S_ON,         S_HEATING),
+    STATE_(S_HEATING, S_BUSY,       SST_HSM_NONE),
+    STATE_(S_COOLING, S_BUSY,       SST_HSM_NONE),
+    STATE_(S_ERROR,   S_ON,         S_ALARM),
+    STATE_(S_ALARM,   S_ERROR,      SST_HSM_NONE),
+    STATE_(S_MUTED,   S_ERROR,      SST_HSM_NONE),
+    STATE_(S_OFF,     SST_HSM_NONE, SST_HSM_NONE)
+};
+
+static SSTHsmTran const l_trans[] = {
+    { S_ON,      SIG_POWER, S_OFF,        (SSTHsmAction)0 },
+    { S_ON,      SIG_FAULT, S_ERROR,      (SSTHsmAction)0 },
+    { S_ON,      SIG_TICK,  SST_HSM_NONE, &act1 },
+    { S_IDLE,    SIG_START, S_BUSY,       (SSTHsmAction)0 },
+    { S_BUSY,    SIG_STOP,  S_IDLE,       (SSTHsmAction)0 },
+    { S_BUSY,    SIG_TICK,  SST_HSM_NONE, &act2 },
+    { S_HEATING, SIG_HOT,   S_COOLING,    &act3 },
+    { S_COOLING, SIG_COLD,  S_HEATING,    (SSTHsmAction)0 },
+    { S_COOLING, SIG_ACK,   S_COOLING,    &act4 },
+    { S_ERROR,   SIG_RESET, S_ON,         &act5 },
+    { S_ALARM,   SIG_ACK,   S_MUTED,      &act6 },
+    { S_MUTED,   SIG_FAULT, S_ALARM,      (SSTHsmAction)0 },
+    { S_OFF,     SIG_POWER, S_ON,         (SSTHsmAction)0 }
+};
+
+static SSTHsmDef const l_def = {
+    l_states, l_trans, N_STATES,
+    (uint8_t)(sizeof(l_trans) / sizeof(l_trans[0])), S_ON, SIG_END
+};
+
+static SSTHsm l_hsm;
+static uint16_t l_work[512];                 /* aligned for the cells */
+
+__attribute__((noinline))
+SST_HSM_TASK(hsmTask, l_hsm)
+
+/* the switch-based task ...................................................*/
+static uint8_t l_swState = SST_HSM_NONE;
+
+static uint8_t swSuper_(uint8_t s) {
+    switch (s) {
+        case S_IDLE:
+        case S_BUSY:
+        case S_ERROR:    return S_ON;
+        case S_HEATING:
+        case S_COOLING:  return S_BUSY;
+        case S_ALARM:
+        case S_MUTED:    return S_ERROR;
+        default:         return SST_HSM_NONE;
+    }
+}
+static uint8_t swInit_(uint8_t s) {
+    switch (s) {
+        case S_ON:       return S_IDLE;
+        case S_BUSY:     return S_HEATING;
+        case S_ERROR:    return S_ALARM;
+        default:         return SST_HSM_NONE;
+    }
+}
+/* returns 1 when 's' handles 'sig', with its target and action (0: none) */
+static uint8_t swHandle_(uint8_t s, SSTSignal sig,
+                         uint8_t *target, uint8_t *act)
+{
+    *act = 0U;
+    switch (s) {
+        case S_ON:
+            switch (sig) {
+                case SIG_POWER: *target = S_OFF;                 return 1U;
+                case SIG_FAULT: *target = S_ERROR;               return 1U;
+                case SIG_TICK:  *target = SST_HSM_NONE; *act = 1U;
+                                                                 return 1U;
+            }
+            break;
+        case S_IDLE:
+            switch (sig) {
+                case SIG_START: *target = S_BUSY;                return 1U;
+            }
+            break;
+        case S_BUSY:
+            switch (sig) {
+                case SIG_STOP:  *target = S_IDLE;                return 1U;
+                case SIG_TICK:  *target = SST_HSM_NONE; *act = 2U;
+                                                                 return 1U;
+            }
+            break;
+        case S_HEATING:
+            switch (sig) {
+                case SIG_HOT:   *target = S_COOLING; *act = 3U;  return 1U;
+            }
+            break;
+        case S_COOLING:
+            switch (sig) {
+                case SIG_COLD:  *target = S_HEATING;             return 1U;
+                case SIG_ACK:   *target = S_COOLING; *act = 4U;  return 1U;
+            }
+            break;
+        case S_ERROR:
+            switch (sig) {
+                case SIG_RESET: *target = S_ON; *act = 5U;       return 1U;
+            }
+            break;
+        case S_ALARM:
+            switch (sig) {
+                case SIG_ACK:   *target = S_MUTED; *act = 6U;    return 1U;
+            }
+            break;
+        case S_MUTED:
+            switch (sig) {
+                case SIG_FAULT: *target = S_ALARM;               return 1U;
+            }
+            break;
+        case S_OFF:
+            switch (sig) {
+                case SIG_POWER: *target = S_ON;                  return 1U;
+            }
+            break;
+    }
+    return 0U;
+}
+static uint8_t swContains_(uint8_t a, uint8_t s) {
+    for (s = swSuper_(s); s != SST_HSM_NONE; s = swSuper_(s)) {
+        if (s == a) {
+            return 1U;
+        }
+    }
+    return 0U;
+}
+static uint8_t swLca_(uint8_t src, uint8_t tgt) {       /* as in sst_hsm.c */
+    uint8_t s;
+    if (src == tgt) {
+        return swSuper_(src);
+    }
+    if (swContains_(tgt, src)) {
+        return swSuper_(tgt);
+    }
+    if (swContains_(src, tgt)) {
+        return src;
+    }
+    for (s = swSuper_(src); s != SST_HSM_NONE; s = swSuper_(s)) {
+        if (swContains_(s, tgt)) {
+            break;
+        }
+    }
+    return s;
+}
+static void swEnter_(uint8_t lca, uint8_t target, SSTEvent const *e) {
+    uint8_t path[N_STATES];
+    uint8_t n = 0U;
+    uint8_t s;
+    for (s = target; s != lca; s = swSuper_(s)) {
+        path[n++] = s;
+    }
+    while (n != 0U) {
+        mix_(ENTRY_(path[--n]), e);
+    }
+    for (s = target; swInit_(s) != SST_HSM_NONE; ) {
+        s = swInit_(s);
+        mix_(ENTRY_(s), e);
+    }
+    l_swState = s;
+}
+__attribute__((noinline))
+void swTask(SSTEvent e) {
+    uint8_t target = SST_HSM_NONE;
+    uint8_t act = 0U;
+    uint8_t src;
+    uint8_t lca;
+    uint8_t s;
+
+    if (l_swState == SST_HSM_NONE) {
+        swEnter_(SST_HSM_NONE, S_ON, &e);     /* the initial transition */
+        return;
+    }
+    for (src = l_swState; src != SST_HSM_NONE; src = swSuper_(src)) {
+        if (swHandle_(src, e.sig, &target, &act)) {
+            break;
+        }
+    }
+    if (src == SST_HSM_NONE) {
+        return;                                    /* unhandled, ignored */
+    }
+    if (target == SST_HSM_NONE) {                  /* internal transition */
+        if (act != 0U) {
+            mix_(ACT_(act), &e);
+        }
+        return;
+    }
+    lca = swLca_(src, target);
+    for (s = l_swState; s != lca; s = swSuper_(s)) {
+        mix_(EXIT_(s), &e);
+    }
+    if (act != 0U) {
+        mix_(ACT_(act), &e);
+    }
+    swEnter_(lca, target, &e);
+}
+
+/*..........................................................................*/
+static SSTEvent l_hsmQueue[1];
+static SSTEvent l_swQueue[1];
+static SSTEvent l_sigs[N_EVENTS];          /* the same events for both */
+
+static double perEvent(void (*post)(SSTEvent e)) {  /* best of N_ROUNDS */
+    uint64_t best = ~(uint64_t)0;
+    uint32_t r;
+    uint32_t i;
+    for (r = 0U; r < N_ROUNDS; ++r) {
+        uint64_t t = bench_now();
+        for (i = 0U; i < N_EVENTS; ++i) {
+            (*post)(l_sigs[i]);
+        }
+        t = bench_now() - t;
+        if (t < best) {
+            best = t;
+        }
+    }
+    return (double)best / N_EVENTS;
+}
+static void postHsm(SSTEvent e) {
+    SST_post(HSM_PRIO, e.sig, e.par);
+}
+static void postSw(SSTEvent e) {
+    SST_post(SW_PRIO, e.sig, e.par);
+}
+/*..........................................................................*/
+static uint32_t run(void (*task)(SSTEvent e), uint8_t const *state) {
+    uint32_t i;
+    l_sum = 0U;
+    for (i = 0U; i < N_EVENTS; ++i) {
+        (*task)(l_sigs[i]);
+        if (*state == SST_HSM_NONE) {
+            return 0U;                            /* must have started */
+        }
+    }
+    return l_sum;
+}
+
+/*..........................................................................*/
+int main(void) {
+    uint32_t seed = 1U;
+    uint32_t hsmSum;
+    uint32_t swSum;
+    uint32_t i;
+
+    for (i = 0U; i < N_EVENTS; ++i) {     /* SIG_START..SIG_END mixed */
+        uint32_t r = bench_rand(&seed);
+        l_sigs[i].sig = (SSTSignal)(SIG_START
+                                    + r % (SIG_END - SIG_START + 1));
+        l_sigs[i].par = (SSTParam)(r >> 8);
+    }
+    l_sigs[0].sig = INIT_SIG;
+
+    if (!SST_hsmInit(&l_hsm, &l_def, (void *)0, l_work, sizeof(l_work))) {
+        printf("SST_hsmInit failed, %u bytes needed\n",
+               (unsigned)SST_hsmWorkSize(&l_def));
+        return 1;
+    }
+    hsmSum = run(&hsmTask, &l_hsm.state__);
+    swSum = run(&swTask, &l_swState);
+    if ((hsmSum == 0U) || (hsmSum != swSum)
+        || (SST_hsmState(&l_hsm) != l_swState))
+    {
+        printf("the tasks disagree: checksum %08x/%08x, state %u/%u\n",
+               (unsigned)hsmSum, (unsigned)swSum,
+               (unsigned)SST_hsmState(&l_hsm), (unsigned)l_swState);
+        return 1;
+    }
+
+    SST_task(&hsmTask, HSM_PRIO, l_hsmQueue, 1, SIG_END, 0);
+    SST_task(&swTask, SW_PRIO, l_swQueue, 1, SIG_END, 0);
+    SST_run();
+
+    printf("table-driven HSM against the switch-based task (%s per event)\n",
+           BENCH_UNIT);
+    printf("%-34s %8s %8s\n", "", "table", "switch");
+    printf("%-34s %8.1f %8.1f\n", "dispatch, direct call",
+           perEvent(&hsmTask), perEvent(&swTask));
+    printf("%-34s %8.1f %8.1f\n", "SST_post + dispatch",
+           perEvent(&postHsm), perEvent(&postSw));
+    printf("%-34s %8u\n", "workspace, bytes",
+           (unsigned)SST_hsmWorkSize(&l_def));
+    printf("checksum %08x after %u events, both tasks\n",
+           (unsigned)hsmSum, N_EVENTS);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************
+* SST benchmark: periodic tick vs. tickless idle on the simulated clock
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define N_TASKS    4
+#define SIM_SEC    600U                       /* simulated run, seconds */
+
+enum { MODE_TICK, MODE_TICKLESS_RAW, MODE_TICKLESS };
+
+static uint16_t const l_period[N_TASKS] = {    /* ms, the apps + a fast one */
+    5000U, 3000U, 4000U, 70U
+};
+static SSTEvent l_queues[N_TASKS][2];
+static SSTTimeEvt l_timeEvt[N_TASKS];
+static uint32_t l_nEvents;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+    SST_tickless();
+}
+
+static void task(SSTEvent e) {
+    if (e.sig == TICK_SIG) {
+        ++l_nEvents;
+    }
+}
+
+/*..........................................................................*/
+static void run(uint8_t mode) {
+    static char const * const name[] = {
+        "periodic tick", "tickless, raw", "tickless, corrected"
+    };
+    uint64_t end = (uint64_t)SIM_SEC * SST_POSIX_LP_HZ;
+    uint64_t t0;
+    uint8_t i;
+
+    SST_posixSimReset((uint8_t)(mode == MODE_TICKLESS));
+    for (i = 0; i < N_TASKS; ++i) {
+        uint16_t ticks = (uint16_t)(l_period[i] * SST_POSIX_TICK_HZ / 1000U);
+        SST_timeEvtArm(&l_timeEvt[i], ticks, ticks);
+    }
+    l_nEvents = 0;
+    t0 = bench_ns();
+    while (SST_posixSimNow() < end) {
+        if (mode == MODE_TICK) {
+            SST_posixSimTick();
+        }
+        else {
+            SST_onIdle();
+        }
+    }
+    t0 = bench_ns() - t0;
+    for (i = 0; i < N_TASKS; ++i) {
+        SST_timeEvtDisarm(&l_timeEvt[i]);
+    }
+    printf("%-20s %10.2f %10u %10d %12.1f\n", name[mode],
+           (double)SST_posixSimWakeups() / SIM_SEC, l_nEvents,
+           SST_posixSimDriftUs(), (double)t0 / 1e6);
+}
+
+/*..........................................................................*/
+/* a wakeup later than the period of an event: one post, still periodic */
+static uint8_t lateWakeup(void) {
+    uint32_t first;
+    uint32_t next;
+    SST_timeEvtArm(&l_timeEvt[0], 1U, 1U);
+    l_nEvents = 0;
+    SST_tickAnnounce(3U);
+    first = l_nEvents;
+    SST_tickAnnounce(1U);
+    next = l_nEvents - first;
+    SST_timeEvtDisarm(&l_timeEvt[0]);
+    printf("late wakeup, 3 ticks of a 1-tick event: %u post(s), then %u\n",
+           (unsigned)first, (unsigned)next);
+    return (uint8_t)((first == 1U) && (next == 1U));
+}
+
+/*..........................................................................*/
+int main(void) {
+    uint8_t i;
+    for (i = 0; i < N_TASKS; ++i) {
+        SST_task(&task, (uint8_t)(i + 1U), l_queues[i], 2, INIT_SIG, 0);
+        SST_timeEvtInit(&l_timeEvt[i], (uint8_t)(i + 1U), TICK_SIG, 0);
+    }
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    if (!lateWakeup()) {
+        return 1;
+    }
+    printf("%u s simulated, %u Hz tick, %u Hz low-power timer\n",
+           SIM_SEC, SST_POSIX_TICK_HZ, SST_POSIX_LP_HZ);
+    printf("%-20s %10s %10s %10s %12s\n", "mode", "wakeups/s", "events",
+           "drift us", "host ms");
+    run(MODE_TICK);
+    run(MODE_TICKLESS_RAW);
+    run(MODE_TICKLESS);
+    return 0;
+}
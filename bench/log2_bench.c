@@ -0,0 +1,129 @@
+/*****************************************************************************
+* SST benchmark: highest-priority lookup (SST_LOG2) vs. the linear scan
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "sst_log2.h"
+#include "bench.h"
+
+#define N_SETS  4096U
+#define N_REPS  256U
+
+static uint64_t l_sets[N_SETS];
+static volatile uint32_t l_sink;
+
+/* the bit-by-bit scan that SST_schedule_() used before SST_LOG2() */
+static uint8_t scanLkup(uint64_t rs, uint8_t width) {
+    uint8_t n = 0;
+    uint64_t b = (uint64_t)1 << (width - 1);
+    while (n < width) {
+        if (rs & (b >> n)) {
+            return (uint8_t)(width - n);
+        }
+        n++;
+    }
+    return 0;
+}
+
+/* fill the sets with 'density' random bits; density 0 means only bit 0,
+ * which is the worst case for the scan (lowest-priority task ready) */
+static void fillSets(uint8_t width, uint8_t density) {
+    uint32_t seed = 0x2545F491U;
+    uint32_t i;
+    for (i = 0; i < N_SETS; ++i) {
+        uint64_t rs = 0;
+        uint8_t k;
+        if (density == 0) {
+            rs = 1;
+        }
+        for (k = 0; k < density; ++k) {
+            rs |= (uint64_t)1 << (bench_rand(&seed) % width);
+        }
+        l_sets[i] = rs;
+    }
+}
+
+#define TIME_ENGINE(result_, expr_) do { \
+    uint32_t sum_ = 0; \
+    uint32_t r_, i_; \
+    uint64_t t0_ = bench_now(); \
+    for (r_ = 0; r_ < N_REPS; ++r_) { \
+        for (i_ = 0; i_ < N_SETS; ++i_) { \
+            uint64_t rs = l_sets[i_]; \
+            sum_ += (expr_); \
+        } \
+    } \
+    (result_) = (double)(bench_now() - t0_) / (N_SETS * N_REPS); \
+    l_sink += sum_; \
+} while (0)
+
+static void verify(uint8_t width) {
+    uint32_t i;
+    for (i = 0; i < N_SETS; ++i) {
+        uint64_t rs = l_sets[i];
+        uint8_t ref = scanLkup(rs, width);
+        uint8_t tbl = SST_log2Tbl64(rs);
+        uint8_t sel = SST_log2_64(rs);
+        if ((ref != tbl) || (ref != sel)) {
+            fprintf(stderr, "mismatch for %#llx: scan=%u tbl=%u sel=%u\n",
+                    (unsigned long long)rs, ref, tbl, sel);
+            exit(1);
+        }
+    }
+}
+
+int main(void) {
+    static uint8_t const widths[] = { 8, 16, 32, 64 };
+    static uint8_t const densities[] = { 0, 1, 2, 4, 16, 64 };
+    uint8_t w, d;
+
+    printf("SST_LOG2 engine: %s, unit: %s per lookup\n",
+           SST_LOG2_CLZ ? "clz" : "table", BENCH_UNIT);
+    printf("%6s %8s %10s %10s %10s\n",
+           "prio", "density", "scan", "table", "selected");
+    for (w = 0; w < sizeof(widths); ++w) {
+        uint8_t width = widths[w];
+        for (d = 0; (d < sizeof(densities)) && (densities[d] <= width); ++d) {
+            uint8_t density = densities[d];
+            char label[8];
+            double tScan, tTbl, tSel;
+            fillSets(width, density);
+            verify(width);
+            TIME_ENGINE(tScan, scanLkup(rs, width));
+            switch (width) {
+                case 8:
+                    TIME_ENGINE(tTbl, SST_log2Tbl8((uint8_t)rs));
+                    TIME_ENGINE(tSel, SST_log2_8((uint8_t)rs));
+                    break;
+                case 16:
+                    TIME_ENGINE(tTbl, SST_log2Tbl16((uint16_t)rs));
+                    TIME_ENGINE(tSel, SST_log2_16((uint16_t)rs));
+                    break;
+                case 32:
+                    TIME_ENGINE(tTbl, SST_log2Tbl32((uint32_t)rs));
+                    TIME_ENGINE(tSel, SST_log2_32((uint32_t)rs));
+                    break;
+                default:
+                    TIME_ENGINE(tTbl, SST_log2Tbl64(rs));
+                    TIME_ENGINE(tSel, SST_log2_64(rs));
+                    break;
+            }
+            if (density == 0) {
+                snprintf(label, sizeof(label), "lowest");
+            }
+            else {
+                snprintf(label, sizeof(label), "%u", density);
+            }
+            printf("%6u %8s %10.2f %10.2f %10.2f\n",
+                   width, label, tScan, tTbl, tSel);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*****************************************************************************
+* SST stress test: the deferred log, its drop report and the host decoder
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#if (SST_LOG_LEVEL != SST_LOG_WARN) || !defined(SST_LOG_LEN)
+#error "build the log test with -include log_bench.h -DSST_LOG_LEN=8U"
+#endif
+
+#define TASK_PRIO   1U
+#define CEIL_PRIO   2U                    /* holds the task while posting */
+#define MAX_RECS    (2U * SST_LOG_LEN + 4U)
+#define LOG_TOOL    "python3 ../tools/sst_log.py -a log_bench.h"
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: The log holds SST_LOG_LEN records. A burst of SST_logPut_() calls
+  under the interrupt lock overflows it, and the first SST_logDrainRaw()
+  must report the lost records before the kept ones, in order, and only
+  once. A second burst after a failed post from the kernel and two
+  SST_LOG() calls (one of them above SST_LOG_LEVEL, so compiled out) must
+  report only its own losses. A model of the records checks every byte
+  drained. The dump then goes to a file, tools/sst_log.py decodes it with
+  the messages of log_bench.h, and each line must match the record
+  formatted here from the same message tables. Run it from bench/, where
+  the tool and the header are found; an argument keeps the dump.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#define LVL_(id_, lvl_, fmt_)  "-EWID"[lvl_],
+#define FMT_(id_, lvl_, fmt_)  fmt_,
+static char const l_lvl[SST_LOG_N_MSGS] = {
+    SST_LOG_MSGS(LVL_)
+    SST_LOG_APP_MSGS(LVL_)
+};
+static char const * const l_fmt[SST_LOG_N_MSGS] = {
+    SST_LOG_MSGS(FMT_)
+    SST_LOG_APP_MSGS(FMT_)
+};
+
+static SSTEvent l_queue[1];
+static SSTLogRec l_got[MAX_RECS];             /* what the drains wrote */
+static uint16_t l_nGot;
+static SSTLogRec l_exp[MAX_RECS];                          /* the model */
+static uint16_t l_nExp;
+static uint32_t l_errors;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void task(SSTEvent e) {
+    (void)e;
+}
+static void out(void const *data, uint16_t len) {
+    if ((len == (uint16_t)sizeof(SSTLogRec)) && (l_nGot < MAX_RECS)) {
+        memcpy(&l_got[l_nGot], data, len);
+    }
+    ++l_nGot;
+}
+static void model(uint8_t id, uint16_t a, uint32_t b) {
+    l_exp[l_nExp].id = id;
+    l_exp[l_nExp].reserved = 0U;
+    l_exp[l_nExp].a = a;
+    l_exp[l_nExp].b = b;
+    ++l_nExp;
+}
+/* the drop report goes ahead of the records of the next drain, at 'from' */
+static void burst(uint16_t n, uint16_t room, uint16_t k, uint16_t from) {
+    uint16_t i;
+    SST_INT_LOCK();                        /* where the kernel calls it */
+    for (i = 0; i < n; ++i) {
+        SST_logPut_((uint8_t)BENCH_LOG_SEQ, i, k);
+    }
+    SST_INT_UNLOCK();
+    if (n > room) {
+        memmove(&l_exp[from + 1U], &l_exp[from],
+                (l_nExp - from) * sizeof(SSTLogRec));
+        ++l_nExp;
+        l_exp[from].id = (uint8_t)SST_LOG_DROPPED;
+        l_exp[from].reserved = 0U;
+        l_exp[from].a = (uint16_t)(n - room);
+        l_exp[from].b = 0U;
+    }
+    for (i = 0; i < ((n < room) ? n : room); ++i) {
+        model((uint8_t)BENCH_LOG_SEQ, i, k);
+    }
+}
+static void expect(char const *what, uint8_t ok) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "ERROR");
+    if (!ok) {
+        ++l_errors;
+    }
+}
+static uint8_t drained(uint16_t from) {
+    return (uint8_t)((l_nGot == l_nExp)
+                     && (memcmp(&l_got[from], &l_exp[from],
+                                (l_nExp - from) * sizeof(SSTLogRec)) == 0));
+}
+
+/*..........................................................................*/
+static void records(void) {
+    uint16_t from;
+    uint8_t n;
+    uint8_t org;
+
+    printf("log of %u records\n", (unsigned)SST_LOG_LEN);
+    burst(SST_LOG_LEN + 5U, SST_LOG_LEN, 1U, 0U);
+    expect("SST_logDropped() counts the 5 lost records",
+           (uint8_t)(SST_logDropped() == 5U));
+    n = SST_logDrainRaw(&out, 0xFFU);
+    expect("the drain reports them first, then the kept ones",
+           (uint8_t)((n == SST_LOG_LEN) && drained(0U)));
+    from = l_nGot;
+    n = SST_logDrainRaw(&out, 0xFFU);
+    expect("a second drain writes nothing",
+           (uint8_t)((n == 0U) && (l_nGot == from)));
+
+    org = SST_mutexLock(CEIL_PRIO);
+    SST_post(TASK_PRIO, TICK_SIG, 0);
+    SST_post(TASK_PRIO, KBD_SIG, 0);                  /* the queue is full */
+    SST_mutexUnlock(org);
+    model((uint8_t)SST_LOG_POST_FAIL, TASK_PRIO, KBD_SIG);
+    SST_LOG(BENCH_LOG_HEX, 0xBEEFU, 0U);
+    model((uint8_t)BENCH_LOG_HEX, 0xBEEFU, 0U);
+    SST_LOG(BENCH_LOG_INFO, 1U, 2U);                     /* compiled out */
+    burst(SST_LOG_LEN, SST_LOG_LEN - 2U, 2U, from);
+    n = SST_logDrainRaw(&out, 0xFFU);
+    expect("a failed post and SST_LOG(), then only new losses",
+           (uint8_t)((n == SST_LOG_LEN) && drained(from)));
+    expect("SST_logDropped() counts all 7",
+           (uint8_t)(SST_logDropped() == 7U));
+}
+/*..........................................................................*/
+static void decode(char const *path) {
+    char cmd[256];
+    char line[128];
+    char exp[128];
+    FILE *f = fopen(path, "wb");
+    uint16_t i = 0U;
+    uint8_t ok = 1U;
+
+    if (f == (FILE *)0) {
+        expect("the dump file can be written", 0U);
+        return;
+    }
+    fwrite(l_got, sizeof(SSTLogRec), l_nGot, f);
+    fclose(f);
+    printf("%u records decoded by tools/sst_log.py\n", (unsigned)l_nGot);
+    snprintf(cmd, sizeof(cmd), "%s %s", LOG_TOOL, path);
+    f = popen(cmd, "r");
+    if (f == (FILE *)0) {
+        expect("the tool can be started", 0U);
+        return;
+    }
+    while (fgets(line, sizeof(line), f) != (char *)0) {   /* read it all */
+        SSTLogRec const *r;
+        int len;
+        if (i >= l_nGot) {                             /* an extra line */
+            ok = 0U;
+            continue;
+        }
+        r = &l_got[i];
+        len = snprintf(exp, sizeof(exp), "%c ", l_lvl[r->id]);
+        snprintf(&exp[len], sizeof(exp) - (size_t)len, l_fmt[r->id],
+                 (unsigned)r->a, (unsigned)r->b);
+        line[strcspn(line, "\n")] = '\0';
+        if (strcmp(line, exp) != 0) {
+            printf("    %s\n    expected: %s\n", line, exp);
+            ok = 0U;
+        }
+        ++i;
+    }
+    ok &= (uint8_t)(pclose(f) == 0);
+    expect("decodes every record as formatted here",
+           (uint8_t)(ok && (i == l_nGot)));
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    SST_task(&task, TASK_PRIO, l_queue, 1U, INIT_SIG, 0);
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    records();
+    decode((argc > 1) ? argv[1] : "log_bench.bin");
+    if (argc <= 1) {
+        remove("log_bench.bin");
+    }
+    printf("%s\n", (l_errors == 0U) ? "ok" : "ERRORS");
+    return (l_errors == 0U) ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+/*****************************************************************************
+* SST stress test: messages the deferred log test adds to the kernel's
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#ifndef log_bench_h
+#define log_bench_h
+
+/* included ahead of every source (-include), like an application's
+ * messages defined in its sst_port.h
+ */
+#define SST_LOG_APP_MSGS(X_) \
+    X_(BENCH_LOG_SEQ,  SST_LOG_WARN,  "record %u, burst %u") \
+    X_(BENCH_LOG_HEX,  SST_LOG_ERROR, "value 0x%x") \
+    X_(BENCH_LOG_INFO, SST_LOG_INFO,  "compiled out at SST_LOG_WARN")
+
+#endif                                                       /* log_bench_h */
@@ -0,0 +1,196 @@
+/*****************************************************************************
+* SST stress test: the shared event pool against a reference model
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#ifndef SST_EVT_POOL
+#error "pool_bench needs SST_EVT_POOL"
+#endif
+
+#define N_ROUNDS    50000U
+#define N_NODES     5U
+#define MAX_POSTS   14U
+#define CEIL_PRIO   3U               /* holds the tasks while posting */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Every round registers a pool of N_NODES nodes shared by two tasks,
+  one with a reserve of 2 events and one with a reserve of 0 or 1, picks
+  an overflow policy for both, and posts a random burst of normal and
+  urgent events to them while a mutex ceiling holds them. A plain array
+  per task models what its queue must hold: a post succeeds while the task
+  has reserve left or the pool a node to lend, and otherwise the policy
+  decides. Each post must succeed or fail like in the model, the tasks
+  must then run exactly the modeled events in order, and afterwards every
+  node must be back in the pool.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static SSTEvent l_q1[2];
+static SSTEvent l_q2[1];
+static SSTEvtNode l_nodes[N_NODES];
+static uint16_t l_got[2U * MAX_POSTS];              /* what the tasks ran */
+static uint8_t l_nGot;
+static uint16_t l_ref[3][MAX_POSTS];           /* the model, per priority */
+static uint8_t l_nRef[3];
+static uint8_t l_reserve[3];
+static uint8_t l_maxUsed;                      /* over all the rounds */
+static uint32_t l_fails;
+static uint32_t l_seed = 1U;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void task(SSTEvent e) {
+    if (e.sig != INIT_SIG) {
+        l_got[l_nGot++] = (uint16_t)(e.sig * 100U + e.par);
+    }
+}
+static uint8_t borrowed(void) {
+    uint8_t n = 0;
+    uint8_t p;
+    for (p = 1U; p <= 2U; ++p) {
+        if (l_nRef[p] > l_reserve[p]) {
+            n += (uint8_t)(l_nRef[p] - l_reserve[p]);
+        }
+    }
+    return n;
+}
+static void modelInsert(uint8_t p, uint16_t v, uint8_t urgent) {
+    uint16_t *r = l_ref[p];
+    if (urgent) {
+        memmove(&r[1], &r[0], l_nRef[p] * sizeof(r[0]));
+        r[0] = v;
+    }
+    else {
+        r[l_nRef[p]] = v;
+    }
+    ++l_nRef[p];
+}
+static uint8_t modelPost(uint8_t p, SSTSignal sig, SSTParam par,
+                         uint8_t urgent, uint8_t policy)
+{
+    uint16_t *r = l_ref[p];
+    uint16_t v = (uint16_t)(sig * 100U + par);
+    uint8_t i;
+    if ((l_nRef[p] < l_reserve[p]) || (borrowed() < N_NODES)) {
+        modelInsert(p, v, urgent);
+        return 1U;
+    }
+    if (l_nRef[p] == 0U) {                /* nothing the policy could drop */
+        return 0U;
+    }
+    switch (policy) {
+        case SST_OVF_DROP_OLDEST:
+            memmove(&r[0], &r[1], (l_nRef[p] - 1U) * sizeof(r[0]));
+            --l_nRef[p];
+            modelInsert(p, v, urgent);
+            return 1U;
+        case SST_OVF_OVERWRITE_LATEST:
+            if (urgent) {
+                --l_nRef[p];
+                modelInsert(p, v, 1U);
+            }
+            else {
+                r[l_nRef[p] - 1U] = v;
+            }
+            return 1U;
+        case SST_OVF_COALESCE:
+            for (i = l_nRef[p]; i-- != 0U; ) {
+                if (r[i] / 100U == sig) {
+                    r[i] = v;
+                    return 1U;
+                }
+            }
+            return 0U;
+        default:
+            return 0U;
+    }
+}
+
+/*..........................................................................*/
+static uint8_t round_(uint32_t n) {
+    uint8_t policy = (uint8_t)(bench_rand(&l_seed) % SST_OVF_POLICIES);
+    uint8_t nPosts = (uint8_t)(bench_rand(&l_seed) % MAX_POSTS);
+    uint16_t exp[2U * MAX_POSTS];
+    uint8_t nExp = 0;
+    uint8_t org;
+    uint8_t i;
+
+    SST_evtPoolInit(l_nodes, (uint8_t)N_NODES);
+    l_reserve[1] = 2U;
+    l_reserve[2] = (uint8_t)(bench_rand(&l_seed) % 2U);
+    SST_task(&task, 1U, l_q1, l_reserve[1], INIT_SIG, 0);
+    SST_task(&task, 2U, l_q2, l_reserve[2], INIT_SIG, 0);
+    SST_taskOverflow(1U, policy);
+    SST_taskOverflow(2U, policy);
+    l_nRef[1] = 0U;
+    l_nRef[2] = 0U;
+
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < nPosts; ++i) {
+        uint8_t p = (uint8_t)(1U + bench_rand(&l_seed) % 2U);
+        SSTSignal sig = (SSTSignal)(1U + bench_rand(&l_seed) % 3U);
+        uint8_t urgent = (uint8_t)(bench_rand(&l_seed) % 3U == 0U);
+        uint8_t ok = urgent ? SST_postUrgent(p, sig, i)
+                            : SST_post(p, sig, i);
+        if (ok != modelPost(p, sig, i, urgent, policy)) {
+            printf("round %u, post %u: SST_post() gave %u\n",
+                   (unsigned)n, (unsigned)i, (unsigned)ok);
+            SST_mutexUnlock(org);
+            return 0U;
+        }
+    }
+    l_nGot = 0;
+    SST_mutexUnlock(org);             /* the higher priority task runs first */
+
+    for (i = 0; i < l_nRef[2]; ++i) {
+        exp[nExp++] = l_ref[2][i];
+    }
+    for (i = 0; i < l_nRef[1]; ++i) {
+        exp[nExp++] = l_ref[1][i];
+    }
+    if ((l_nGot != nExp)
+        || (memcmp(l_got, exp, nExp * sizeof(exp[0])) != 0))
+    {
+        printf("round %u, policy %u: the tasks ran other events\n",
+               (unsigned)n, (unsigned)policy);
+        return 0U;
+    }
+    if (SST_evtPoolUsed() != 0U) {
+        printf("round %u: %u nodes not returned\n",
+               (unsigned)n, (unsigned)SST_evtPoolUsed());
+        return 0U;
+    }
+    if (SST_evtPoolMaxUsed() > l_maxUsed) {
+        l_maxUsed = SST_evtPoolMaxUsed();
+    }
+    l_fails += SST_evtPoolFails();
+    return 1U;
+}
+
+/*..........................................................................*/
+int main(void) {
+    uint32_t n;
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    for (n = 0; n < N_ROUNDS; ++n) {
+        if (!round_(n)) {
+            printf("MODEL MISMATCH\n");
+            return 1;
+        }
+    }
+    printf("%u rounds, pool of %u nodes: model ok, most used %u, fails %u\n",
+           (unsigned)N_ROUNDS, (unsigned)N_NODES,
+           (unsigned)l_maxUsed, (unsigned)l_fails);
+    return 0;
+}
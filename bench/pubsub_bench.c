@@ -0,0 +1,84 @@
+/*****************************************************************************
+* SST benchmark: SST_publish() fan-out vs. a loop of SST_post()
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define N_ROUNDS   100000U
+#define CEIL_PRIO  SST_MAX_PRIO
+
+static SSTEvent l_queues[SST_MAX_PRIO][2];
+static uint32_t l_nEvents;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+static void subscriber(SSTEvent e) {
+    if (e.sig == TICK_SIG) {
+        ++l_nEvents;
+    }
+}
+
+/*..........................................................................*/
+/* one fan-out of TICK_SIG to 'n' tasks, posted from the idle level (every
+ * SST_post() preempts) or from under a mutex ceiling (no preemption, so
+ * only the posting is measured)
+ */
+static double fanOut(uint8_t n, uint8_t publish, uint8_t ceiling) {
+    uint32_t r;
+    uint64_t t = 0;
+    l_nEvents = 0;
+    for (r = 0; r < N_ROUNDS; ++r) {
+        uint8_t org = ceiling ? SST_mutexLock(CEIL_PRIO) : (uint8_t)0;
+        uint64_t t0 = bench_now();
+        if (publish) {
+            SST_publish(TICK_SIG, 0);
+        }
+        else {
+            uint8_t p;
+            for (p = n; p >= 1U; --p) {         /* highest priority first */
+                SST_post(p, TICK_SIG, 0);
+            }
+        }
+        t += bench_now() - t0;
+        if (ceiling) {
+            SST_mutexUnlock(org);
+        }
+    }
+    if (l_nEvents != (uint32_t)n * N_ROUNDS) {
+        printf("lost events: %u of %u\n", l_nEvents, n * N_ROUNDS);
+    }
+    return (double)t / N_ROUNDS;
+}
+
+/*..........................................................................*/
+int main(void) {
+    static uint8_t const subscribers[] = { 1, 2, 4, 8, 16, SST_MAX_PRIO - 1 };
+    uint8_t i;
+    uint8_t p = 1;
+
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    printf("fan-out of one event, %s per fan-out\n", BENCH_UNIT);
+    printf("%-12s %12s %12s %12s %12s\n", "subscribers",
+           "post loop", "publish", "post (ceil)", "publish (ceil)");
+    for (i = 0; i < sizeof(subscribers); ++i) {
+        for (; p <= subscribers[i]; ++p) {
+            SST_task(&subscriber, p, l_queues[p - 1], 2, INIT_SIG, 0);
+            SST_subscribe(p, TICK_SIG);
+        }
+        printf("%-12u %12.1f %12.1f %12.1f %12.1f\n", subscribers[i],
+               fanOut(subscribers[i], 0, 0), fanOut(subscribers[i], 1, 0),
+               fanOut(subscribers[i], 0, 1), fanOut(subscribers[i], 1, 1));
+    }
+    return 0;
+}
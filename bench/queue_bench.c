@@ -0,0 +1,96 @@
+/*****************************************************************************
+* SST benchmark: Queue bytes/second, per-byte API vs. SST_enqueueN/dequeueN
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define TOTAL_BYTES  (16U * 1024U * 1024U)
+
+static uint32_t l_memStorage[(64U * 16U) / sizeof(uint32_t)];
+static uint8_t l_src[64U * 16U];
+static uint8_t l_dst[64U * 16U];
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static double perByte(uint8_t size) {
+    Queue q;
+    uint32_t done = 0;
+    uint64_t t0;
+    SST_initQueue(&q, size);
+    t0 = bench_ns();
+    while (done < TOTAL_BYTES) {
+        uint8_t i;
+        uint8_t b;
+        for (i = 0; i < size; ++i) {
+            SST_enqueue(&q, l_src[i]);
+        }
+        for (i = 0; i < size; ++i) {
+            SST_dequeue(&q, &b);
+            l_dst[i] = b;
+        }
+        done += size;
+    }
+    t0 = bench_ns() - t0;
+    SST_freeQueue(&q);
+    return (double)done * 1e3 / (double)t0;               /* MB/s */
+}
+/*..........................................................................*/
+static double bulk(uint8_t size, uint8_t elemSize, uint8_t chunk) {
+    Queue q;
+    uint32_t done = 0;
+    uint64_t t0;
+    SST_initQueueElem(&q, size, elemSize);
+    t0 = bench_ns();
+    while (done < TOTAL_BYTES) {
+        uint8_t n = 0;             /* keep the indexes wrapping around */
+        while (n < size) {
+            n = (uint8_t)(n + SST_enqueueN(&q, l_src, chunk));
+            if (SST_dequeueN(&q, l_dst, chunk) == 0U) {
+                break;
+            }
+        }
+        done += (uint32_t)n * elemSize;
+    }
+    t0 = bench_ns() - t0;
+    SST_freeQueue(&q);
+    return (double)done * 1e3 / (double)t0;
+}
+
+/*..........................................................................*/
+int main(void) {
+    static uint8_t const sizes[]  = { 64, 60 };
+    static uint8_t const elems[]  = { 1, 4, 16 };
+    static uint8_t const chunks[] = { 1, 8, 32 };
+    uint8_t s, e, c;
+
+    SST_memInit(l_memStorage, sizeof(l_memStorage), sizeof(l_memStorage));
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+
+    printf("Queue throughput in MB/s\n");
+    printf("%-6s %-6s %-12s %10s\n", "size", "elem", "api", "MB/s");
+    for (s = 0; s < sizeof(sizes); ++s) {
+        printf("%-6u %-6u %-12s %10.1f\n", sizes[s], 1,
+               "per-byte", perByte(sizes[s]));
+        for (e = 0; e < sizeof(elems); ++e) {
+            for (c = 0; c < sizeof(chunks); ++c) {
+                char api[16];
+                snprintf(api, sizeof(api), "N=%u", chunks[c]);
+                printf("%-6u %-6u %-12s %10.1f\n", sizes[s], elems[e],
+                       api, bulk(sizes[s], elems[e], chunks[c]));
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*****************************************************************************
+* SST benchmark and stress test: SSTRing single-producer/single-consumer
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include "sst_port.h"
+#include "sst_ring.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define N_OPS       1000000U
+#define N_STRESS    4000000U
+#define RING_PRIO   1U
+#define ISR_BURST   8U
+#define N_TICKS     2000U
+
+typedef struct {
+    uint32_t seq;
+    uint8_t  pad[12];
+} Elem16;
+
+static uint32_t l_ringStorage[4096U];
+static uint32_t l_memStorage[64];
+static SSTRing l_ring;
+static SSTEvent l_queue[4];
+static volatile uint32_t l_popped;
+static volatile uint32_t l_pushed;
+static volatile uint32_t l_ticks;
+static uint32_t l_notified;
+static uint32_t l_errors;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void costPerOp(void) {
+    Queue q;
+    uint32_t i, v = 0;
+    uint8_t b;
+    uint64_t t0;
+    double tRing, tQueue;
+
+    SST_ringInit(&l_ring, l_ringStorage, 64U, (uint8_t)sizeof(uint32_t));
+    t0 = bench_now();
+    for (i = 0; i < N_OPS; ++i) {
+        SST_ringPush(&l_ring, &i);
+        SST_ringPop(&l_ring, &v);
+    }
+    tRing = (double)(bench_now() - t0) / N_OPS;
+
+    SST_memInit(l_memStorage, sizeof(l_memStorage), sizeof(l_memStorage));
+    SST_initQueue(&q, 64U);
+    t0 = bench_now();
+    for (i = 0; i < N_OPS; ++i) {
+        SST_enqueue(&q, (uint8_t)i);
+        SST_dequeue(&q, &b);
+    }
+    tQueue = (double)(bench_now() - t0) / N_OPS;
+    SST_freeQueue(&q);
+
+    printf("push+pop, one thread (%s)\n", BENCH_UNIT);
+    printf("  %-32s %8.1f\n", "SSTRing, 4-byte elements", tRing);
+    printf("  %-32s %8.1f\n", "Queue, SST_enqueue/SST_dequeue", tQueue);
+}
+
+/*..........................................................................*/
+static void *producer(void *arg) {
+    Elem16 e;
+    uint32_t i;
+    memset(&e, 0xA5, sizeof(e));
+    for (i = 0; i < N_STRESS; ++i) {
+        e.seq = i;
+        while (!SST_ringPush(&l_ring, &e)) {
+            sched_yield();             /* full, let the consumer run */
+        }
+    }
+    (void)arg;
+    return (void *)0;
+}
+static void stress(uint16_t capacity, uint8_t elemSize) {
+    pthread_t th;
+    Elem16 e;
+    uint32_t expected = 0;
+    uint64_t t0;
+    SST_ringInit(&l_ring, l_ringStorage, capacity, elemSize);
+    l_errors = 0;
+    t0 = bench_ns();
+    pthread_create(&th, (pthread_attr_t *)0, &producer, (void *)0);
+    while (expected < N_STRESS) {
+        if (SST_ringPop(&l_ring, &e)) {
+            if ((e.seq != expected)
+                || ((elemSize > 4U) && (e.pad[elemSize - 5U] != 0xA5U)))
+            {
+                ++l_errors;
+            }
+            ++expected;
+        }
+        else {
+            sched_yield();            /* empty, let the producer run */
+        }
+    }
+    pthread_join(th, (void **)0);
+    printf("  capacity %5u, %2u-byte elements: %8.1f M/s, %s\n",
+           capacity, elemSize,
+           (double)N_STRESS * 1e3 / (double)(bench_ns() - t0),
+           (l_errors == 0U) ? "sequence ok" : "SEQUENCE ERRORS");
+}
+
+/*..........................................................................*/
+static void ringTask(SSTEvent e) {                /* drains on every notify */
+    uint32_t v;
+    if (e.sig == TICK_SIG) {
+        ++l_notified;
+        while (SST_ringPop(&l_ring, &v)) {
+            if (v != l_popped) {
+                ++l_errors;
+            }
+            ++l_popped;
+        }
+    }
+}
+static void ringIsr(void) {       /* pushes without taking the SST lock */
+    uint8_t pin;
+    uint32_t k;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    for (k = 0; k < ISR_BURST; ++k) {
+        uint32_t v = l_pushed;
+        if (SST_ringPush(&l_ring, &v)) {
+            l_pushed = v + 1U;
+        }
+    }
+    ++l_ticks;
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void isrToTask(void) {
+    SST_ringInit(&l_ring, l_ringStorage, 16U, (uint8_t)sizeof(uint32_t));
+    SST_ringNotify(&l_ring, RING_PRIO, TICK_SIG);
+    SST_task(&ringTask, RING_PRIO, l_queue, 4U, INIT_SIG, 0);
+    l_errors = 0;
+    SST_posixIrqAttach(0, SIGALRM, &ringIsr);
+    SST_posixTimerStart(100U);
+    while (l_ticks < N_TICKS) {
+    }
+    SST_posixTimerStop();
+    printf("ISR -> task with notify: %u pushed, %u popped, %u events, %s\n",
+           l_pushed, l_popped, l_notified,
+           ((l_errors == 0U) && (l_pushed == l_popped))
+           ? "sequence ok" : "SEQUENCE ERRORS");
+}
+
+/*..........................................................................*/
+int main(void) {
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    costPerOp();
+    printf("two-thread stress, %u elements\n", N_STRESS);
+    stress(16U, 4U);
+    stress(1024U, 4U);
+    stress(16U, 16U);
+    stress(1024U, 16U);
+    isrToTask();
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*****************************************************************************
+* SST benchmark: post-to-dispatch latency, preemption cost and throughput
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <signal.h>
+#include <string.h>
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define N_SAMPLES  100000U
+#define MAX_DEPTH  64U
+#define LAT_PRIO   (SST_MAX_PRIO - 1)
+#define CEIL_PRIO  SST_MAX_PRIO        /* above every task of the benchmark */
+
+static SSTEvent l_queues[SST_MAX_PRIO][MAX_DEPTH];
+static uint32_t l_samples[N_SAMPLES];
+static uint32_t l_nSamples;
+static uint64_t l_tPost;                /* timestamp taken before posting */
+static uint32_t l_nEvents;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void latTask(SSTEvent e) {            /* records post-to-dispatch */
+    if ((e.sig == TICK_SIG) && (l_nSamples < N_SAMPLES)) {
+        l_samples[l_nSamples++] = (uint32_t)(bench_now() - l_tPost);
+    }
+}
+static void countTask(SSTEvent e) {
+    if (e.sig == TICK_SIG) {
+        ++l_nEvents;
+    }
+}
+static void latIsr(void) {
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    SST_post(LAT_PRIO, TICK_SIG, 0);
+    SST_ISR_EXIT(pin, (void)0);
+}
+
+/*..........................................................................*/
+static int cmpU32(void const *a, void const *b) {
+    uint32_t x = *(uint32_t const *)a;
+    uint32_t y = *(uint32_t const *)b;
+    return (x > y) - (x < y);
+}
+static void report(char const *what) {
+    uint64_t sum = 0;
+    uint32_t i;
+    qsort(l_samples, l_nSamples, sizeof(l_samples[0]), &cmpU32);
+    for (i = 0; i < l_nSamples; ++i) {
+        sum += l_samples[i];
+    }
+    printf("%-34s %8u %8.1f %8u %8u\n", what, l_samples[0],
+           (double)sum / l_nSamples, l_samples[l_nSamples / 2],
+           l_samples[(l_nSamples * 99U) / 100U]);
+    l_nSamples = 0;
+}
+
+/*..........................................................................*/
+static void benchLatency(void) {
+    uint32_t i;
+    SST_task(&latTask, LAT_PRIO, l_queues[LAT_PRIO - 1], 1, INIT_SIG, 0);
+
+    printf("\n%-34s %8s %8s %8s %8s   (%s)\n", "latency", "min", "avg",
+           "median", "p99", BENCH_UNIT);
+    for (i = 0; i < N_SAMPLES; ++i) {     /* task-level, idle -> LAT_PRIO */
+        l_tPost = bench_now();
+        SST_post(LAT_PRIO, TICK_SIG, 0);
+    }
+    report("post-to-dispatch, from task");
+
+    SST_posixIrqAttach(0, SIGUSR1, &latIsr);
+    for (i = 0; i < N_SAMPLES; ++i) {       /* signal -> ISR -> post -> task */
+        l_tPost = bench_now();
+        SST_posixIrqRaise(0);
+    }
+    report("post-to-dispatch, from ISR");
+}
+/*..........................................................................*/
+static void benchPreemption(void) {
+    uint32_t i;
+    double tPreempt, tEnqueue;
+    uint64_t t0;
+    SST_task(&countTask, LAT_PRIO, l_queues[LAT_PRIO - 1], 1, INIT_SIG, 0);
+
+    t0 = 0;
+    for (i = 0; i < N_SAMPLES; ++i) {   /* post, dispatch, run, return */
+        uint64_t t1 = bench_now();
+        SST_post(LAT_PRIO, TICK_SIG, 0);
+        t0 += bench_now() - t1;
+    }
+    tPreempt = (double)t0 / N_SAMPLES;
+
+    t0 = 0;
+    for (i = 0; i < N_SAMPLES; ++i) {      /* post only, no preemption */
+        uint8_t p = SST_mutexLock(CEIL_PRIO);
+        uint64_t t1 = bench_now();
+        SST_post(LAT_PRIO, TICK_SIG, 0);
+        t0 += bench_now() - t1;
+        SST_mutexUnlock(p);
+    }
+    tEnqueue = (double)t0 / N_SAMPLES;
+
+    printf("\n%-34s %8.1f %s\n", "SST_post with preemption", tPreempt,
+           BENCH_UNIT);
+    printf("%-34s %8.1f %s\n", "SST_post without preemption", tEnqueue,
+           BENCH_UNIT);
+    printf("%-34s %8.1f %s\n", "synchronous preemption cost",
+           tPreempt - tEnqueue, BENCH_UNIT);
+}
+/*..........................................................................*/
+static void benchThroughput(void) {
+    static uint8_t const tasks[]  = { 1, 4, 8, 16, SST_MAX_PRIO - 1 };
+    static uint8_t const depths[] = { 1, 4, 16, MAX_DEPTH };
+    uint8_t t, d;
+
+    printf("\n%-8s %-8s %14s   (all queues filled, then one schedule)\n",
+           "tasks", "depth", "events/s");
+    for (t = 0; t < sizeof(tasks); ++t) {
+        for (d = 0; d < sizeof(depths); ++d) {
+            uint32_t rounds = 2000000U / (tasks[t] * depths[d]) + 1U;
+            uint32_t r;
+            uint64_t t0;
+            uint8_t p;
+            for (p = 1; p <= tasks[t]; ++p) {
+                SST_task(&countTask, p, l_queues[p - 1], depths[d],
+                         INIT_SIG, 0);
+            }
+            l_nEvents = 0;
+            t0 = bench_ns();
+            for (r = 0; r < rounds; ++r) {
+                uint8_t org = SST_mutexLock(CEIL_PRIO);
+                uint8_t k;
+                for (p = 1; p <= tasks[t]; ++p) {
+                    for (k = 0; k < depths[d]; ++k) {
+                        SST_post(p, TICK_SIG, k);
+                    }
+                }
+                SST_mutexUnlock(org);            /* dispatches everything */
+            }
+            printf("%-8u %-8u %14.0f\n", tasks[t], depths[d],
+                   (double)l_nEvents * 1e9 / (double)(bench_ns() - t0));
+        }
+    }
+}
+
+/*..........................................................................*/
+int main(void) {
+    printf("SST scheduler benchmark, SST_MAX_PRIO = %u\n", SST_MAX_PRIO);
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    benchLatency();
+    benchPreemption();
+    benchThroughput();
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*****************************************************************************
+* SST stress test: counting semaphores and the handoff to the top waiter
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define N_TASKS     3U
+#define QUEUE_LEN   4U
+#define CEIL_PRIO   (N_TASKS + 1U)   /* holds the tasks while signalling */
+
+enum {
+    WAIT_SIG = COLOR_SIG + 1,          /* par: the SST_wait() calls to make */
+};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Three tasks call SST_wait() on WAIT_SIG, and once more on the
+  SIGNAL_SEM_SIG that wakes them, and log their priority for every token
+  they get. The idle loop signals, either directly, so that a woken task
+  preempts it at once, or under a mutex ceiling, so that several grants
+  are pending before any task runs. Each case checks the log and the
+  count, waiters and grants left in the semaphore.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static SSTEvent l_queue[N_TASKS + 1U][QUEUE_LEN];
+static Semaphore l_sem;
+static uint8_t l_got[16];                       /* who got a token, in order */
+static uint8_t l_nGot;
+static uint32_t l_errors;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void waiter(SSTEvent e) {
+    uint8_t n;
+    switch (e.sig) {
+        case WAIT_SIG:
+            for (n = e.par; n != 0U; --n) {
+                if (!SST_wait(&l_sem)) {
+                    break;                    /* blocked, SIGNAL_SEM_SIG next */
+                }
+                l_got[l_nGot++ & 15U] = SST_currPrio_;
+            }
+            break;
+        case SIGNAL_SEM_SIG:
+            if (SST_wait(&l_sem)) {
+                l_got[l_nGot++ & 15U] = SST_currPrio_;
+            }
+            break;
+        default:
+            break;
+    }
+}
+static uint8_t waiters(void) {                /* the queue as a bit mask */
+    uint8_t m = 0;
+    uint8_t p;
+    for (p = 1U; p <= N_TASKS; ++p) {
+        if (SST_prioSetHas(&l_sem.queue, p)) {
+            m |= (uint8_t)(1U << p);
+        }
+    }
+    return m;
+}
+static uint8_t grants(void) {
+    uint8_t m = 0;
+    uint8_t p;
+    for (p = 1U; p <= N_TASKS; ++p) {
+        if (SST_prioSetHas(&l_sem.granted, p)) {
+            m |= (uint8_t)(1U << p);
+        }
+    }
+    return m;
+}
+static void expect(char const *what, uint8_t const *order, uint8_t n,
+                   uint8_t count, uint8_t waiting, uint8_t granted)
+{
+    uint8_t ok = (uint8_t)((l_nGot == n) && (l_sem.c == count)
+                           && (waiters() == waiting)
+                           && (grants() == granted));
+    uint8_t i;
+    for (i = 0; ok && (i < n); ++i) {
+        ok = (uint8_t)(l_got[i] == order[i]);
+    }
+    printf("  %-48s %s\n", what, ok ? "ok" : "ERROR");
+    if (!ok) {
+        printf("    got %u tokens, count %u, waiters 0x%02X, grants 0x%02X\n",
+               (unsigned)l_nGot, (unsigned)l_sem.c,
+               (unsigned)waiters(), (unsigned)grants());
+        ++l_errors;
+    }
+    l_nGot = 0;
+}
+
+/*..........................................................................*/
+static void counting(void) {
+    static uint8_t const three[] = { 1U, 1U, 1U };
+    static uint8_t const woken[] = { 1U };
+    uint8_t ok = 1U;
+    uint8_t i;
+
+    printf("counting semaphore (3 of 5 tokens)\n");
+    SST_initSemCounting(&l_sem, 3U, 5U);
+    SST_post(1U, WAIT_SIG, 4U);
+    expect("4 waits take 3 tokens, then block", three, 3U, 0U, 0x02U, 0U);
+
+    SST_signal(&l_sem);
+    expect("signal hands the token to the waiter", woken, 1U, 0U, 0U, 0U);
+
+    for (i = 0; i < 5U; ++i) {
+        ok &= SST_signal(&l_sem);
+    }
+    ok &= (uint8_t)(SST_signal(&l_sem) == 0U);       /* beyond the maximum */
+    expect("5 signals fill it, the 6th is refused", three, 0U, 5U, 0U, 0U);
+    if (!ok) {
+        printf("    SST_signal() did not return 1, 1, 1, 1, 1, 0\n");
+        ++l_errors;
+    }
+
+    SST_post(1U, WAIT_SIG, 3U);
+    expect("3 waits take 3 of the 5 tokens", three, 3U, 2U, 0U, 0U);
+}
+/*..........................................................................*/
+static void handoff(void) {
+    static uint8_t const topDown[] = { 3U, 2U, 1U };
+    static uint8_t const low[] = { 1U };
+    static uint8_t const high[] = { 3U };
+    uint8_t org;
+    uint8_t p;
+
+    printf("handoff to the top waiter\n");
+    SST_initSemCounting(&l_sem, 0U, 3U);
+    for (p = 1U; p <= N_TASKS; ++p) {
+        SST_post(p, WAIT_SIG, 1U);                    /* all three block */
+    }
+    expect("3 tasks block on an empty semaphore", topDown, 0U,
+           0U, 0x0EU, 0U);
+
+    org = SST_mutexLock(CEIL_PRIO);
+    SST_signal(&l_sem);
+    SST_signal(&l_sem);
+    expect("2 signals under a ceiling grant 3 and 2", topDown, 0U,
+           0U, 0x02U, 0x0CU);
+    SST_mutexUnlock(org);
+    expect("3 and 2 then take their tokens", topDown, 2U, 0U, 0x02U, 0U);
+
+    SST_signal(&l_sem);
+    expect("the next signal goes to 1", low, 1U, 0U, 0U, 0U);
+
+    SST_post(1U, WAIT_SIG, 1U);
+    org = SST_mutexLock(CEIL_PRIO);
+    SST_signal(&l_sem);                                    /* granted to 1 */
+    SST_post(3U, WAIT_SIG, 1U);            /* 3 runs first, cannot steal it */
+    SST_mutexUnlock(org);
+    expect("a granted token is not taken by a higher task", low, 1U,
+           0U, 0x08U, 0U);
+
+    SST_signal(&l_sem);
+    expect("the blocked higher task gets the next one", high, 1U,
+           0U, 0U, 0U);
+}
+/*..........................................................................*/
+static void kept(void) {
+    static uint8_t const two[] = { 2U, 2U };
+    uint8_t ok;
+
+    printf("token signalled with no waiter\n");
+    SST_initSemCounting(&l_sem, 0U, 2U);
+    ok = SST_signal(&l_sem);
+    expect("the count keeps it", two, 0U, 1U, 0U, 0U);
+    if (!ok) {
+        printf("    SST_signal() returned 0\n");
+        ++l_errors;
+    }
+    SST_post(2U, WAIT_SIG, 2U);
+    expect("the next wait takes it, the one after blocks", two, 1U,
+           0U, 0x04U, 0U);
+    SST_signal(&l_sem);
+    expect("and the blocked wait is woken by the next", two, 1U,
+           0U, 0U, 0U);
+}
+
+/*..........................................................................*/
+int main(void) {
+    uint8_t p;
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    for (p = 1U; p <= N_TASKS; ++p) {
+        SST_task(&waiter, p, l_queue[p], QUEUE_LEN, INIT_SIG, 0);
+    }
+    counting();
+    handoff();
+    kept();
+    printf("%s\n", (l_errors == 0U) ? "ok" : "ERRORS");
+    return (l_errors == 0U) ? 0 : 1;
+}
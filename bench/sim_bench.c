@@ -0,0 +1,147 @@
+/*****************************************************************************
+* SST virtual-time simulation of an ESP8266 workload
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define CMD_PRIO      1U
+#define PARSER_PRIO   3U
+#define CTRL_PRIO     5U
+#define TICK_IRQ      0U
+#define UART_IRQ      1U
+#define LINE_SIG      (COLOR_SIG + 1)
+
+#define RUN_S         10U
+#define TICK_US       1000U                           /* 1kHz kernel tick */
+#define CTRL_TICKS    10U                     /* control loop every 10ms */
+#define LINE_US       20000U                /* a command line every 20ms */
+#define LINE_LEN      24U
+#define BYTE_US       87U                          /* 115200 baud, 8N1 */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: A 1kHz tick drives a control loop every 10ms, and a UART receives
+  a command line of LINE_LEN bytes every 20ms, a byte per interrupt. The
+  parser task takes the bytes and hands every complete line to the command
+  task, which takes 1.5ms per line. The parser queue length is the knob:
+  the default, 8, loses bytes while the control loop runs, and running
+  "sim_bench 16" shows what a longer queue buys. Given a trace file, the
+  UART arrivals are read from it instead of generated ("<us> 1 <byte>").
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static SSTEvent l_parserQueue[255];
+static SSTEvent l_cmdQueue[2];
+static SSTEvent l_ctrlQueue[2];
+static SSTTimeEvt l_ctrlTimer;
+static uint32_t l_seed = 1U;
+static uint8_t l_lineLen;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void tickIsr(void) {
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    SST_simCost((uint32_t)SST_SIM_US(2U));
+    SST_tick();
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void uartIsr(void) {
+    uint8_t pin;
+    uint8_t c = SST_simIrqPar();
+    SST_ISR_ENTRY(pin, KBD_ISR_PRIO);
+    SST_simCost((uint32_t)SST_SIM_US(3U));
+    SST_post(PARSER_PRIO, KBD_SIG, c);
+    SST_ISR_EXIT(pin, (void)0);
+}
+/*..........................................................................*/
+static void parserTask(SSTEvent e) {
+    if (e.sig != KBD_SIG) {
+        return;
+    }
+    SST_simCost((uint32_t)SST_SIM_US(25U));
+    if (e.par == (SSTParam)'\n') {
+        SST_post(CMD_PRIO, LINE_SIG, l_lineLen);
+        l_lineLen = 0U;
+    }
+    else {
+        ++l_lineLen;
+    }
+}
+static void cmdTask(SSTEvent e) {
+    if (e.sig == LINE_SIG) {
+        SST_simCost((uint32_t)SST_SIM_US(1500U));
+    }
+}
+static void ctrlTask(SSTEvent e) {
+    if (e.sig == TICK_SIG) {             /* 500..1000us, data dependent */
+        uint32_t us = 500U + bench_rand(&l_seed) % 501U;
+        SST_simCost((uint32_t)SST_SIM_US(us));
+    }
+}
+/*..........................................................................*/
+static void scriptUart(void) {
+    uint64_t line;
+    for (line = 0U; line < (uint64_t)RUN_S * 1000000U / LINE_US; ++line) {
+        uint64_t at = SST_SIM_US(line * LINE_US + bench_rand(&l_seed) % 2000U);
+        uint8_t i;
+        for (i = 0U; i < (uint8_t)LINE_LEN; ++i) {
+            (void)SST_simArrive(at + SST_SIM_US((uint64_t)i * BYTE_US),
+                                UART_IRQ, (i == LINE_LEN - 1U)
+                                          ? (uint8_t)'\n' : (uint8_t)'a');
+        }
+    }
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    long qlen = (argc > 1) ? atol(argv[1]) : 8L;
+    uint64_t t0;
+    double host;
+
+    if ((qlen < 1L) || (qlen > 255L)) {
+        qlen = 8L;
+    }
+    SST_simIrqAttach(TICK_IRQ, TICK_ISR_PRIO, &tickIsr,
+                     (uint32_t)SST_SIM_US(1U));
+    SST_simIrqAttach(UART_IRQ, KBD_ISR_PRIO, &uartIsr,
+                     (uint32_t)SST_SIM_US(1U));
+    (void)SST_simPeriodic(TICK_IRQ, 0U, SST_SIM_US(TICK_US),
+                          SST_SIM_US(TICK_US), 0U);
+    if (argc > 2) {
+        if (SST_simLoad(argv[2]) < 0) {
+            printf("cannot read the trace %s\n", argv[2]);
+            return 1;
+        }
+    }
+    else {
+        scriptUart();
+    }
+
+    SST_task(&cmdTask, CMD_PRIO, l_cmdQueue, 2U, INIT_SIG, 0);
+    SST_task(&parserTask, PARSER_PRIO, l_parserQueue, (uint8_t)qlen,
+             INIT_SIG, 0);
+    SST_task(&ctrlTask, CTRL_PRIO, l_ctrlQueue, 2U, INIT_SIG, 0);
+    SST_timeEvtInit(&l_ctrlTimer, CTRL_PRIO, TICK_SIG, 0);
+    SST_timeEvtArm(&l_ctrlTimer, CTRL_TICKS, CTRL_TICKS);
+
+    t0 = bench_ns();
+    SST_simRun(SST_SIM_US((uint64_t)RUN_S * 1000000U));
+    host = (double)(bench_ns() - t0) * 1e-9;
+
+    printf("parser queue of %ld events\n", qlen);
+    SST_simReport(stdout);
+    printf("%u s simulated in %.3f s, %.0fx real time\n", (unsigned)RUN_S,
+           host, (double)RUN_S / host);
+    return 0;
+}
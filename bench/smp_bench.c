@@ -0,0 +1,189 @@
+/*****************************************************************************
+* SST benchmark: partitioned kernels on host threads, events per second
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <unistd.h>
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define WORKER_PRIO  1U
+#define WORK_SIG     (COLOR_SIG + 1)
+#define TOKENS       4U            /* events circulating in every kernel */
+#define QUEUE_LEN    64U          /* >= all the tokens, nothing is lost */
+#define INBOX_LEN    64U
+#define WORK_ROUNDS  64U          /* xorshift rounds per event, the work */
+#define WARMUP_MS    50U
+#define RUN_MS       300U
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Every kernel runs one worker task with TOKENS events in flight. The
+  worker does a fixed amount of work per event and posts the event on: to
+  itself, or with the 'remote' rate to the worker of another kernel with
+  SST_postTo(), so the events wander between the kernels. The queues and
+  inboxes hold all the tokens, so no event is lost and the counts are the
+  events run per second, summed over the kernels.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+typedef struct {
+    SSTKernel k;
+    SSTInboxMsg inbox[INBOX_LEN];
+    SSTEvent queue[QUEUE_LEN];
+    uint32_t seed;
+    uint32_t sink;
+    uint32_t remote;                       /* events posted to the others */
+    volatile uint64_t done;
+} __attribute__((aligned(64))) Core;
+
+static Core l_core[SST_MAX_KERNELS];
+static uint8_t l_nCores;
+static uint8_t l_mixed;              /* 1/8 of the posts go remote */
+static volatile uint8_t l_stop;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void worker(SSTEvent e) {
+    Core *c = &l_core[SST_kernel_->id__];
+    uint32_t x = c->seed;
+    uint32_t i;
+    if (e.sig != WORK_SIG) {
+        return;
+    }
+    for (i = 0U; i < WORK_ROUNDS; ++i) {
+        x = bench_rand(&x);
+    }
+    c->seed = x;
+    c->sink += x;
+    c->done = c->done + 1U;
+    if (__atomic_load_n(&l_stop, __ATOMIC_RELAXED)) {
+        return;                                    /* the token retires */
+    }
+    if (l_mixed && (l_nCores > 1U) && ((x & 7U) == 0U)) {
+        uint8_t to = (uint8_t)((SST_kernel_->id__ + 1U
+                                + (x >> 8) % (l_nCores - 1U)) % l_nCores);
+        ++c->remote;
+        SST_postTo(&l_core[to].k, WORKER_PRIO, WORK_SIG, e.par);
+    }
+    else {
+        SST_post(WORKER_PRIO, WORK_SIG, e.par);
+    }
+}
+/*..........................................................................*/
+static void coreInit(void) {
+    Core *c = &l_core[SST_kernel_->id__];
+    uint8_t i;
+    SST_task(&worker, WORKER_PRIO, c->queue, QUEUE_LEN, INIT_SIG, 0);
+    for (i = 0U; i < TOKENS; ++i) {
+        SST_post(WORKER_PRIO, WORK_SIG, i);
+    }
+}
+/*..........................................................................*/
+static uint64_t doneSum(void) {
+    uint64_t n = 0U;
+    uint8_t i;
+    for (i = 0U; i < l_nCores; ++i) {
+        n += l_core[i].done;
+    }
+    return n;
+}
+static void sleepMs(uint32_t ms) {
+    struct timespec d;
+    d.tv_sec = (time_t)(ms / 1000U);
+    d.tv_nsec = (long)(ms % 1000U) * 1000000L;
+    nanosleep(&d, (struct timespec *)0);
+}
+/*..........................................................................*/
+/* runs 'n' kernels, returns millions of events per second, 0 on a loss */
+static double run(uint8_t n, uint8_t mixed, long nCpu, uint32_t *remote)
+{
+    uint64_t d0, t0;
+    uint8_t i;
+    uint32_t lost = 0U;
+    double rate;
+
+    l_nCores = n;
+    l_mixed = mixed;
+    l_stop = 0U;
+    for (i = 0U; i < n; ++i) {              /* all inboxes before any post */
+        Core *c = &l_core[i];
+        SST_kernelInit(&c->k, i);
+        SST_inboxInit(&c->k, c->inbox, INBOX_LEN);
+        c->seed = 1U + i;
+        c->sink = 0U;
+        c->remote = 0U;
+        c->done = 0U;
+    }
+    for (i = 0U; i < n; ++i) {
+        SST_posixCoreStart(&l_core[i].k, &coreInit, (int)(i % nCpu));
+    }
+    sleepMs(WARMUP_MS);
+    d0 = doneSum();
+    t0 = bench_ns();
+    sleepMs(RUN_MS);
+    rate = (double)(doneSum() - d0) * 1e3 / (double)(bench_ns() - t0);
+    __atomic_store_n(&l_stop, 1U, __ATOMIC_RELAXED);
+    sleepMs(10U);                          /* let the last tokens retire */
+    *remote = 0U;
+    for (i = 0U; i < n; ++i) {
+        SST_posixCoreStop(&l_core[i].k);
+    }
+    for (i = 0U; i < n; ++i) {
+        uint8_t p;
+        lost += SST_inboxDrops(&l_core[i].k);
+        for (p = 0U; p < (uint8_t)SST_OVF_POLICIES; ++p) {
+            lost += l_core[i].k.ovfDrops__[p];
+        }
+        *remote += l_core[i].remote;
+    }
+    return (lost == 0U) ? rate : 0.0;
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    long nCpu = sysconf(_SC_NPROCESSORS_ONLN);
+    long maxCores = (nCpu < 2) ? 2 : nCpu;
+    double local1 = 0.0;
+    double remote1 = 0.0;
+    uint8_t n;
+
+    if (argc > 1) {
+        maxCores = atol(argv[1]);
+    }
+    if ((maxCores < 1) || (maxCores > SST_MAX_KERNELS)) {
+        maxCores = SST_MAX_KERNELS;
+    }
+    if (nCpu < 1) {
+        nCpu = 1;
+    }
+    printf("partitioned kernels, one per thread, %ld online CPUs "
+           "(Mevents/s, speedup)\n", nCpu);
+    printf("%6s %10s %8s %14s %8s %10s\n", "kernels", "local", "",
+           "1/8 remote", "", "remote");
+    for (n = 1U; n <= (uint8_t)maxCores; ++n) {
+        uint32_t remote;
+        double local = run(n, 0U, nCpu, &remote);
+        double mixed = run(n, 1U, nCpu, &remote);
+        if ((local == 0.0) || (mixed == 0.0)) {
+            printf("events lost with %u kernels\n", (unsigned)n);
+            return 1;
+        }
+        if (n == 1U) {
+            local1 = local;
+            remote1 = mixed;
+        }
+        printf("%6u %10.2f %7.2fx %14.2f %7.2fx %10u\n", (unsigned)n,
+               local, local / local1, mixed, mixed / remote1,
+               (unsigned)remote);
+    }
+    return 0;
+}
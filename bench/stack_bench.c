@@ -0,0 +1,168 @@
+/*****************************************************************************
+* SST stress test: single-stack depth profile and painted high-water mark
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <pthread.h>
+#include <signal.h>
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#ifndef SST_STACK_PROF
+#error "stack_bench needs SST_STACK_PROF"
+#endif
+
+#define N_TASKS     3U
+#define QUEUE_LEN   2U
+#define TASK_BYTES  1024U            /* what each task puts on the stack */
+#define ISR_BYTES   2048U
+#define RUN_BYTES   4096U      /* SST_run() is called this much deeper */
+#define SLACK       512U        /* kernel frames between two dispatches */
+#define STACK_SIZE  (256U * 1024U)
+
+enum {
+    WORK_SIG = COLOR_SIG + 1                   /* par: 1 to raise the ISR */
+};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: The kernel runs on a thread whose stack is a known buffer, so the
+  whole of it can be painted. Each task fills TASK_BYTES of its own frame
+  and then posts to the next priority, which preempts it, so tasks 1, 2
+  and 3 end up nested and each is dispatched at least TASK_BYTES, and at
+  most TASK_BYTES + SLACK, deeper than the one below. SLACK also bounds
+  the difference between two frames of the same depth. The top task can
+  raise an ISR that fills ISR_BYTES; the dispatch samples cannot see it,
+  but the painted high-water mark must grow by at least that much.
+  SST_run() is called RUN_BYTES deeper than the later posts, like on the
+  ESP8266, where it returns to the SDK and the dispatches come from
+  shallower callbacks: the base must move up and no depth may wrap.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static uint8_t l_stack[STACK_SIZE] __attribute__((aligned(64)));
+static SSTEvent l_queue[N_TASKS + 1U][QUEUE_LEN];
+static uint8_t *l_runBase;                  /* the base SST_run() set */
+static uint32_t l_errors;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void isr(void) {
+    volatile uint8_t buf[ISR_BYTES];
+    uint32_t i;
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    for (i = 0; i < ISR_BYTES; ++i) {
+        buf[i] = (uint8_t)i;
+    }
+    (void)buf[0];
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void task(SSTEvent e) {
+    volatile uint8_t buf[TASK_BYTES];
+    uint32_t i;
+    if (e.sig != WORK_SIG) {
+        return;
+    }
+    for (i = 0; i < TASK_BYTES; ++i) {
+        buf[i] = (uint8_t)i;
+    }
+    if (SST_currPrio_ < N_TASKS) {
+        SST_post((uint8_t)(SST_currPrio_ + 1U), WORK_SIG, e.par);
+    }
+    else if (e.par != 0U) {
+        SST_posixIrqRaise(0);
+    }
+    (void)buf[0];
+}
+static void expect(char const *what, uint32_t got, uint32_t lo, uint32_t hi) {
+    uint8_t ok = (uint8_t)((got >= lo) && (got <= hi));
+    printf("  %-44s %6u  %s\n", what, (unsigned)got, ok ? "ok" : "ERROR");
+    if (!ok) {
+        printf("    expected %u..%u\n", (unsigned)lo, (unsigned)hi);
+        ++l_errors;
+    }
+}
+static void __attribute__((noinline)) runDeeper(void) {
+    volatile uint8_t pad[RUN_BYTES];
+    pad[0] = 0U;
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    l_runBase = SST_stackBase_;
+    (void)pad[0];
+}
+
+/*..........................................................................*/
+static void *kernel(void *arg) {
+    SSTStackProf const *prof = &SST_stackProf_;
+    uint32_t hw;
+    uint16_t peak;
+    uint8_t p;
+    (void)arg;
+
+    for (p = 1U; p <= N_TASKS; ++p) {
+        SST_task(&task, p, l_queue[p], QUEUE_LEN, INIT_SIG, 0);
+    }
+    SST_posixIrqAttach(0, SIGUSR1, &isr);
+    runDeeper();
+    SST_stackPaint(l_stack);
+
+    SST_post(1U, WORK_SIG, 0U);              /* from above SST_run()'s frame */
+    printf("3 nested tasks of %u bytes, SST_run() %u bytes deeper\n",
+           (unsigned)TASK_BYTES, (unsigned)RUN_BYTES);
+    expect("base moved up from SST_run()'s",
+           (uint32_t)(SST_stackBase_ - l_runBase), RUN_BYTES - SLACK,
+           STACK_SIZE);
+    expect("task 1 depth", prof->maxDepth[0], 0U, SLACK);
+    expect("task 2 depth - task 1 depth",
+           (uint32_t)(prof->maxDepth[1] - prof->maxDepth[0]),
+           TASK_BYTES, TASK_BYTES + SLACK);
+    expect("task 3 depth - task 2 depth",
+           (uint32_t)(prof->maxDepth[2] - prof->maxDepth[1]),
+           TASK_BYTES, TASK_BYTES + SLACK);
+    expect("peak depth is task 3's", prof->peakDepth,
+           prof->maxDepth[2], prof->maxDepth[2]);
+    expect("most tasks nested", prof->maxNest, N_TASKS, N_TASKS);
+    expect("peak chain length", prof->peakLen, N_TASKS, N_TASKS);
+    for (p = 0U; p < N_TASKS; ++p) {
+        if (prof->peakChain[p] != (uint8_t)(p + 1U)) {
+            printf("  peak chain is not 1 -> 2 -> 3             ERROR\n");
+            ++l_errors;
+            break;
+        }
+    }
+    hw = SST_stackHighWater();
+    expect("high-water mark, no ISR", hw,
+           prof->maxDepth[2] + TASK_BYTES - SLACK, STACK_SIZE);
+
+    peak = prof->peakDepth;
+    SST_post(1U, WORK_SIG, 1U);               /* now with the ISR on top */
+    printf("the same with an ISR of %u bytes on top\n", (unsigned)ISR_BYTES);
+    expect("high-water mark grows by the ISR",
+           SST_stackHighWater() - hw, ISR_BYTES, STACK_SIZE);
+    expect("the dispatch peak does not", prof->peakDepth, peak, peak);
+    SST_stackReport();
+    return (void *)0;
+}
+
+/*..........................................................................*/
+int main(void) {
+    pthread_attr_t attr;
+    pthread_t th;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, l_stack, sizeof(l_stack));
+    if (pthread_create(&th, &attr, &kernel, (void *)0) != 0) {
+        printf("no thread on the painted stack\n");
+        return 1;
+    }
+    pthread_join(th, (void **)0);
+    printf("%s\n", (l_errors == 0U) ? "ok" : "ERRORS");
+    return (l_errors == 0U) ? 0 : 1;
+}
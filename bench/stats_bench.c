@@ -0,0 +1,179 @@
+/*****************************************************************************
+* SST stress test: runtime statistics of tasks with known loads
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <signal.h>
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#ifndef SST_STATS
+#error "stats_bench needs SST_STATS"
+#endif
+
+#define LO_PRIO     1U
+#define HI_PRIO     2U
+#define CEIL_PRIO   3U                  /* holds both tasks while posting */
+#define QUEUE_LEN   4U
+#define N_WORK      3U                  /* events posted to the low task */
+#define LO_US       400U           /* what each run costs, without the */
+#define HI_US       100U           /* code that preempts it */
+#define ISR_US      50U
+#define SLACK_US    60U       /* allowed above the cost: kernel, raise() */
+#define N_TRIES     10U          /* a host thread may be descheduled */
+
+enum {
+    WORK_SIG = COLOR_SIG + 1
+};
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Both tasks spin for a known time on SST_CYCLES(). The low task gets
+  N_WORK events queued at once. Halfway through each run it posts to the
+  high task, which preempts it for HI_US, and raises an ISR that spins for
+  ISR_US, so it runs LO_US of its own inside LO_US + HI_US + ISR_US of
+  wall time. The counts must be exact: dispatches, preemptions suffered,
+  queue high-water marks and failed posts. The times are exclusive, so
+  each maxRun must be its own task's cost and the ISR time N_WORK times
+  ISR_US, within SLACK_US. A host thread can be descheduled in the middle
+  of a run, so the timed part is tried up to N_TRIES times.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static SSTEvent l_loQueue[QUEUE_LEN];
+static SSTEvent l_hiQueue[QUEUE_LEN];
+static uint32_t l_hz;
+static uint32_t l_errors;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void spin(uint32_t us) {
+    uint32_t t0 = SST_CYCLES();
+    uint32_t n = (uint32_t)((uint64_t)us * l_hz / 1000000U);
+    while ((uint32_t)(SST_CYCLES() - t0) < n) {
+    }
+}
+static uint32_t us_(uint64_t cycles) {
+    return (uint32_t)(cycles * 1000000U / l_hz);
+}
+static void isr(void) {
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    spin(ISR_US);
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void loTask(SSTEvent e) {
+    if (e.sig == WORK_SIG) {
+        spin(LO_US / 2U);
+        SST_post(HI_PRIO, WORK_SIG, 0);                 /* preempts now */
+        SST_posixIrqRaise(0);
+        spin(LO_US / 2U);
+    }
+}
+static void hiTask(SSTEvent e) {
+    if (e.sig == WORK_SIG) {
+        spin(HI_US);
+    }
+}
+static void expect(char const *what, uint32_t got, uint32_t lo, uint32_t hi) {
+    uint8_t ok = (uint8_t)((got >= lo) && (got <= hi));
+    if (lo == hi) {
+        printf("  %-36s %8u         %s\n", what, (unsigned)got,
+               ok ? "ok" : "ERROR");
+    }
+    else {
+        printf("  %-36s %8u us      %s\n", what, (unsigned)got,
+               ok ? "ok" : "ERROR");
+    }
+    if (!ok) {
+        printf("    expected %u..%u\n", (unsigned)lo, (unsigned)hi);
+        ++l_errors;
+    }
+}
+static uint8_t within(uint32_t got, uint32_t us) {
+    return (uint8_t)((got >= us) && (got <= us + SLACK_US));
+}
+
+/*..........................................................................*/
+static void run_(SSTStats *st) {
+    uint8_t org;
+    uint8_t i;
+    SST_statsReset();
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < N_WORK; ++i) {
+        SST_post(LO_PRIO, WORK_SIG, i);
+    }
+    SST_mutexUnlock(org);                 /* the low task runs N_WORK times */
+    SST_getStats(st);
+}
+static void loads(void) {
+    SSTStats st;
+    SSTTaskStats const *lo = &st.task[LO_PRIO - 1U];
+    SSTTaskStats const *hi = &st.task[HI_PRIO - 1U];
+    uint8_t n;
+
+    for (n = 1U; n <= N_TRIES; ++n) {
+        run_(&st);
+        if (within(us_(lo->maxRun), LO_US) && within(us_(hi->maxRun), HI_US)
+            && within(us_(st.isrTime), N_WORK * ISR_US))
+        {
+            break;
+        }
+    }
+    printf("two tasks of %u and %u us, an ISR of %u us (try %u)\n",
+           (unsigned)LO_US, (unsigned)HI_US, (unsigned)ISR_US,
+           (unsigned)((n > N_TRIES) ? N_TRIES : n));
+    expect("low task dispatches", lo->dispatches, N_WORK, N_WORK);
+    expect("high task dispatches", hi->dispatches, N_WORK, N_WORK);
+    expect("low task preemptions", lo->preemptions, N_WORK, N_WORK);
+    expect("high task preemptions", hi->preemptions, 0U, 0U);
+    expect("low task queue high-water mark", lo->maxUsed, N_WORK, N_WORK);
+    expect("high task queue high-water mark", hi->maxUsed, 1U, 1U);
+    expect("low task maxRun", us_(lo->maxRun), LO_US, LO_US + SLACK_US);
+    expect("high task maxRun", us_(hi->maxRun), HI_US, HI_US + SLACK_US);
+    expect("low task runTime", us_(lo->runTime),
+           N_WORK * LO_US, N_WORK * (LO_US + SLACK_US));
+    expect("ISR time", us_(st.isrTime),
+           N_WORK * ISR_US, N_WORK * ISR_US + SLACK_US);
+}
+static void fails(void) {
+    SSTStats st;
+    SSTTaskStats const *hi = &st.task[HI_PRIO - 1U];
+    uint8_t org;
+    uint8_t i;
+
+    SST_statsReset();
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < QUEUE_LEN + 2U; ++i) {
+        SST_post(HI_PRIO, WORK_SIG, i);
+    }
+    SST_mutexUnlock(org);
+    SST_getStats(&st);
+    printf("%u posts to a queue of %u\n", (unsigned)(QUEUE_LEN + 2U),
+           (unsigned)QUEUE_LEN);
+    expect("high task dispatches", hi->dispatches, QUEUE_LEN, QUEUE_LEN);
+    expect("high task queue high-water mark", hi->maxUsed,
+           QUEUE_LEN, QUEUE_LEN);
+    expect("high task failed posts", hi->postFails, 2U, 2U);
+}
+
+/*..........................................................................*/
+int main(void) {
+    l_hz = (uint32_t)SST_CYCLES_HZ;
+    SST_task(&loTask, LO_PRIO, l_loQueue, QUEUE_LEN, INIT_SIG, 0);
+    SST_task(&hiTask, HI_PRIO, l_hiQueue, QUEUE_LEN, INIT_SIG, 0);
+    SST_posixIrqAttach(0, SIGUSR1, &isr);
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    loads();
+    fails();
+    printf("%s\n", (l_errors == 0U) ? "ok" : "ERRORS");
+    return (l_errors == 0U) ? 0 : 1;
+}
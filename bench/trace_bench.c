@@ -0,0 +1,103 @@
+/*****************************************************************************
+* SST benchmark: cost of the kernel trace records, and a sample trace dump
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <signal.h>
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#ifndef SST_TRACE
+#error "build the trace benchmark with -DSST_TRACE"
+#endif
+
+#define N_ROUNDS   1000000U
+#define N_DUMPED   8U                       /* ISR rounds left in the dump */
+#define LO_PRIO    1U
+#define HI_PRIO    2U
+
+static SSTEvent l_queues[2][4];
+static FILE *l_dump;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+static void hiTask(SSTEvent e) {
+    (void)e;
+}
+static void loTask(SSTEvent e) {
+    if (e.sig == TICK_SIG) {
+        uint8_t org;
+        SST_post(HI_PRIO, TICK_SIG, 0);                   /* preemption */
+        org = SST_mutexLock(HI_PRIO);
+        SST_post(HI_PRIO, TICK_SIG, 0);        /* deferred to the unlock */
+        SST_mutexUnlock(org);
+    }
+}
+static void tickIsr(void) {
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    SST_post(LO_PRIO, TICK_SIG, 0);
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void dumpOut(void const *data, uint16_t len) {
+    fwrite(data, 1, len, l_dump);
+}
+
+/*..........................................................................*/
+/* one round: post, dispatch, preemption, mutex, deferred preemption */
+static double rounds(uint8_t on) {
+    uint64_t t;
+    uint32_t r;
+    SST_traceEnable(on);
+    t = bench_now();
+    for (r = 0; r < N_ROUNDS; ++r) {
+        SST_post(LO_PRIO, TICK_SIG, 0);
+    }
+    t = bench_now() - t;
+    return (double)t / N_ROUNDS;
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    double off;
+    double on;
+    uint16_t nRec;
+    uint32_t r;
+
+    SST_task(&loTask, LO_PRIO, l_queues[0], 4, INIT_SIG, 0);
+    SST_task(&hiTask, HI_PRIO, l_queues[1], 4, INIT_SIG, 0);
+    SST_posixIrqAttach(0, SIGUSR1, &tickIsr);
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+
+    nRec = SST_traceHead_;
+    SST_post(LO_PRIO, TICK_SIG, 0);               /* records in a round */
+    nRec = (uint16_t)(SST_traceHead_ - nRec);
+    off = rounds(0);
+    on = rounds(1);
+    printf("trace off: %8.1f %s per round\n", off, BENCH_UNIT);
+    printf("trace on:  %8.1f %s per round, %u records\n", on, BENCH_UNIT,
+           nRec);
+    printf("record:    %8.1f %s (timestamp read included)\n",
+           (on - off) / nRec, BENCH_UNIT);
+
+    for (r = 0; r < N_DUMPED; ++r) {            /* the same from an ISR */
+        SST_posixIrqRaise(0);
+    }
+    if (argc > 1) {                               /* dump to argv[1] */
+        l_dump = fopen(argv[1], "wb");
+        if (l_dump != (FILE *)0) {
+            SST_traceDump(&dumpOut);
+            fclose(l_dump);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+/*****************************************************************************
+* SST benchmark and stress test: SST_postUrgent() mixed with SST_post()
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include <signal.h>
+#include "sst_port.h"
+#include "sst_exa.h"
+#include "bench.h"
+
+#define LO_PRIO     1U
+#define HI_PRIO     2U
+#define CEIL_PRIO   3U                /* holds both tasks while posting */
+#define QUEUE_LEN   4U
+#define N_OPS       1000000U
+#define N_TICKS     20000U
+#define TICK_US     50U
+
+enum {
+    NORM_SIG = COLOR_SIG + 1,                   /* par: a sequence number */
+    URG_SIG,
+    NORM_IDLE_SIG,                 /* the stress test, one stream each */
+    NORM_TASK_SIG,
+    URG_ISR_SIG,
+    URG_TASK_SIG,
+    KICK_SIG
+};
+
+static SSTEvent l_loQueue[QUEUE_LEN];
+static SSTEvent l_hiQueue[QUEUE_LEN];
+static uint8_t l_got[16];
+static uint8_t l_nGot;
+static uint8_t l_isrUrgent;            /* what the raised ISR posts */
+static uint8_t l_isrPrio;
+static uint8_t l_isrPar;
+static uint32_t l_errors;
+
+void SST_start(void) {
+}
+void SST_onIdle(void) {
+}
+
+/*..........................................................................*/
+static void record(SSTEvent e) {
+    if ((e.sig == NORM_SIG) || (e.sig == URG_SIG)) {
+        l_got[l_nGot++ & 15U] = e.par;
+    }
+}
+static void isrOrder(void) {
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    if (l_isrUrgent) {
+        SST_postUrgent(l_isrPrio, URG_SIG, l_isrPar);
+    }
+    else {
+        SST_post(l_isrPrio, NORM_SIG, l_isrPar);
+    }
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void raise_(uint8_t urgent, uint8_t prio, uint8_t par) {
+    l_isrUrgent = urgent;
+    l_isrPrio = prio;
+    l_isrPar = par;
+    SST_posixIrqRaise(0);
+}
+static void expect(char const *what, uint8_t const *order, uint8_t n) {
+    uint8_t ok = (uint8_t)(l_nGot == n);
+    uint8_t i;
+    for (i = 0; ok && (i < n); ++i) {
+        ok = (uint8_t)(l_got[i] == order[i]);
+    }
+    printf("  %-44s %s\n", what, ok ? "ok" : "ORDER ERROR");
+    if (!ok) {
+        ++l_errors;
+    }
+    l_nGot = 0;
+}
+
+/*..........................................................................*/
+static void loOrder(SSTEvent e) {
+    record(e);
+    if ((e.sig == NORM_SIG) && (e.par == 1U)) {   /* posts from a task */
+        SST_post(LO_PRIO, NORM_SIG, 10U);
+        SST_postUrgent(LO_PRIO, URG_SIG, 11U);
+        SST_post(HI_PRIO, NORM_SIG, 20U);               /* preempts now */
+    }
+}
+static void hiOrder(SSTEvent e) {
+    record(e);
+}
+/* the tasks are held by a mutex ceiling while the events are posted */
+static void ordering(void) {
+    static uint8_t const isrMix[] = { 5U, 3U, 2U, 4U };
+    static uint8_t const taskMix[] = { 1U, 20U, 11U, 10U };
+    static uint8_t const reject[] = { 30U, 31U, 32U, 33U };
+    static uint8_t const dropOldest[] = { 9U, 31U, 32U, 33U };
+    static uint8_t const overwrite[] = { 9U, 30U, 31U, 7U };
+    uint8_t org;
+    uint8_t i;
+
+    SST_task(&loOrder, LO_PRIO, l_loQueue, QUEUE_LEN, INIT_SIG, 0);
+    SST_task(&hiOrder, HI_PRIO, l_hiQueue, QUEUE_LEN, INIT_SIG, 0);
+    SST_posixIrqAttach(0, SIGUSR1, &isrOrder);
+    printf("ordering\n");
+
+    org = SST_mutexLock(CEIL_PRIO);
+    raise_(0U, LO_PRIO, 2U);
+    raise_(1U, LO_PRIO, 3U);
+    raise_(0U, LO_PRIO, 4U);
+    raise_(1U, LO_PRIO, 5U);
+    SST_mutexUnlock(org);
+    expect("ISR: normal, urgent, normal, urgent", isrMix, 4U);
+
+    org = SST_mutexLock(CEIL_PRIO);
+    raise_(0U, LO_PRIO, 1U);
+    SST_mutexUnlock(org);
+    expect("task: normal, urgent, preempting post", taskMix, 4U);
+
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < QUEUE_LEN; ++i) {
+        SST_post(LO_PRIO, NORM_SIG, (uint8_t)(30U + i));
+    }
+    if (SST_postUrgent(LO_PRIO, URG_SIG, 9U)) {
+        ++l_errors;
+    }
+    SST_mutexUnlock(org);
+    expect("full queue, reject-newest", reject, 4U);
+
+    SST_taskOverflow(LO_PRIO, SST_OVF_DROP_OLDEST);
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < QUEUE_LEN; ++i) {
+        SST_post(LO_PRIO, NORM_SIG, (uint8_t)(30U + i));
+    }
+    raise_(1U, LO_PRIO, 9U);
+    SST_mutexUnlock(org);
+    expect("full queue, drop-oldest, urgent from ISR", dropOldest, 4U);
+
+    SST_taskOverflow(LO_PRIO, SST_OVF_OVERWRITE_LATEST);
+    org = SST_mutexLock(CEIL_PRIO);
+    for (i = 0; i < QUEUE_LEN; ++i) {
+        SST_post(LO_PRIO, NORM_SIG, (uint8_t)(30U + i));
+    }
+    SST_postUrgent(LO_PRIO, URG_SIG, 9U);
+    raise_(0U, LO_PRIO, 7U);
+    SST_mutexUnlock(org);
+    expect("full queue, overwrite-latest", overwrite, 4U);
+    SST_taskOverflow(LO_PRIO, SST_OVF_REJECT_NEWEST);
+}
+
+/*..........................................................................*/
+static void loCost(SSTEvent e) {
+    (void)e;
+}
+static void cost(void) {
+    uint64_t t0;
+    double tPost;
+    double tUrgent;
+    uint32_t i;
+    SST_task(&loCost, LO_PRIO, l_loQueue, QUEUE_LEN, INIT_SIG, 0);
+    t0 = bench_now();
+    for (i = 0; i < N_OPS; ++i) {
+        SST_post(LO_PRIO, NORM_SIG, 0);
+    }
+    tPost = (double)(bench_now() - t0) / N_OPS;
+    t0 = bench_now();
+    for (i = 0; i < N_OPS; ++i) {
+        SST_postUrgent(LO_PRIO, URG_SIG, 0);
+    }
+    tUrgent = (double)(bench_now() - t0) / N_OPS;
+    printf("post and run to completion (%s)\n", BENCH_UNIT);
+    printf("  %-32s %8.1f\n", "SST_post()", tPost);
+    printf("  %-32s %8.1f\n", "SST_postUrgent()", tUrgent);
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: In the stress test the idle loop posts normal events to the low
+  task as fast as its queue takes them, a periodic ISR posts urgent events
+  to it and kicks the high task, which posts one normal and one urgent
+  event to it from task context. Every normal stream must arrive in order,
+  and between an urgent post and the run of that event at most one normal
+  event may start: the one the low task had already taken when the post
+  preempted it. A FIFO queue would let the queued normal events go first.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static uint32_t l_normStarted;          /* normal events the low task ran */
+static uint32_t l_urgIsrAt[256];        /* l_normStarted at each post */
+static uint32_t l_urgTaskAt[256];
+static uint8_t l_nUrgIsr;
+static uint8_t l_nUrgTask;
+static uint8_t l_expIdle;
+static uint8_t l_expTask;
+static uint8_t l_seqTask;
+static uint32_t l_nUrgent;
+static volatile uint32_t l_ticks;
+
+static void loStress(SSTEvent e) {
+    switch (e.sig) {
+        case NORM_IDLE_SIG:
+            ++l_normStarted;
+            if (e.par != l_expIdle++) {
+                ++l_errors;
+            }
+            break;
+        case NORM_TASK_SIG:
+            ++l_normStarted;
+            if (e.par != l_expTask++) {
+                ++l_errors;
+            }
+            break;
+        case URG_ISR_SIG:
+        case URG_TASK_SIG: {
+            uint32_t at = (e.sig == URG_ISR_SIG) ? l_urgIsrAt[e.par]
+                                                 : l_urgTaskAt[e.par];
+            ++l_nUrgent;
+            if (l_normStarted - at > 1U) {
+                ++l_errors;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+static void hiStress(SSTEvent e) {
+    if (e.sig == KICK_SIG) {
+        if (SST_post(LO_PRIO, NORM_TASK_SIG, l_seqTask)) {
+            ++l_seqTask;
+        }
+        l_urgTaskAt[l_nUrgTask] = l_normStarted;
+        if (SST_postUrgent(LO_PRIO, URG_TASK_SIG, l_nUrgTask)) {
+            ++l_nUrgTask;
+        }
+    }
+}
+static void isrStress(void) {
+    uint8_t pin;
+    SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
+    l_urgIsrAt[l_nUrgIsr] = l_normStarted;
+    if (SST_postUrgent(LO_PRIO, URG_ISR_SIG, l_nUrgIsr)) {
+        ++l_nUrgIsr;
+    }
+    if ((l_ticks & 1U) != 0U) {
+        SST_post(HI_PRIO, KICK_SIG, 0);
+    }
+    ++l_ticks;
+    SST_ISR_EXIT(pin, (void)0);
+}
+static void stress(void) {
+    uint8_t seq = 0;
+    uint32_t errors = l_errors;
+    SST_task(&loStress, LO_PRIO, l_loQueue, QUEUE_LEN, INIT_SIG, 0);
+    SST_task(&hiStress, HI_PRIO, l_hiQueue, QUEUE_LEN, INIT_SIG, 0);
+    SST_posixIrqAttach(1, SIGALRM, &isrStress);
+    SST_posixTimerStart(TICK_US);
+    while (l_ticks < N_TICKS) {
+        if (SST_post(LO_PRIO, NORM_IDLE_SIG, seq)) {
+            ++seq;
+        }
+    }
+    SST_posixTimerStop();
+    printf("ISR, task and idle posts: %u ticks, %u normal, %u urgent, %s\n",
+           (unsigned)l_ticks, (unsigned)l_normStarted, (unsigned)l_nUrgent,
+           (l_errors == errors) ? "order ok" : "ORDER ERRORS");
+}
+
+/*..........................................................................*/
+int main(void) {
+    SST_run();                     /* SST_currPrio_ = 0, the idle level */
+    ordering();
+    cost();
+    stress();
+    return (l_errors == 0U) ? 0 : 1;
+}
@@ -29,12 +29,14 @@
 // #define user_procTaskQueueLen    1
 // os_event_t    user_procTaskQueue[user_procTaskQueueLen];
 // static void user_procTask(os_event_t *events);
+#define TICKS_PER_SEC 10
+
 uint32_t time = 0;
 uint8_t sdata;
 
-static volatile os_timer_t timerTA;
-static volatile os_timer_t timerTB;
-static volatile os_timer_t timerTC;
+static SSTTimeEvt timeEvtA;
+static SSTTimeEvt timeEvtC;
+static SSTTimeEvt timeEvtLog;
 static volatile os_timer_t global_timer;
 
 Mailbox mb;
@@ -42,6 +44,7 @@ Mailbox mb;
 static SSTEvent taskAQueue[2];
 static SSTEvent taskBQueue[2];
 static SSTEvent taskCQueue[2];
+static SSTEvent logTaskQueue[1];
 
 void SST_start(void) {
 	// NOTE: SST_start is not implemented.
@@ -52,65 +55,34 @@ void SST_onIdle(void) {
 
 /*	~~~   TICK interrupt handler   ~~~
 *	This function is called when the global_timer overflows.
-*	It is used as a 100ms tick signal and to blink a LED each 1s.
+*	It is the 100ms SST tick that drives the time events of the tasks,
+*	and it counts the seconds and blinks a LED each 1s.
 *	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 */
 static void tickISR() {
-	time = time + 1;
-
-	//Do blinky stuff
-	if (GPIO_REG_READ(GPIO_OUT_ADDRESS) & BIT2)
-	{
-		//Set GPIO2 to LOW
-		gpio_output_set(0, BIT2, BIT2, 0);
-	}
-	else
-	{
-		//Set GPIO2 to HIGH
-		gpio_output_set(BIT2, 0, BIT2, 0);
-	}
-}
-
-/*	~~~   Timer A interrupt handler   ~~~
-*	This function is called when the timerTA overflows.
-*	It posts a TICK_SIG to task A.
-*	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-*/
-static void timerTA_ISR() {
+	static uint8_t ticks = 0;
 	uint8_t pin;
 
 	SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
 
-	SST_post(TASK_A_PRIO, TICK_SIG, 0);     /* post the Tick to Task A */
+	SST_tick();                 /* post the expired time events */
 
-	SST_ISR_EXIT(pin, 0);
-}
+	if (++ticks == TICKS_PER_SEC) {
+		ticks = 0;
+		time = time + 1;
 
-/*	~~~   Timer B interrupt handler   ~~~
-*	This function is called when the timerTB overflows.
-*	It posts a TICK_SIG to task B.
-*	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-*/
-static void timerTB_ISR() {
-	uint8_t pin;
-
-	SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
-
-	SST_post(TASK_B_PRIO, TICK_SIG, 0);     /* post the Tick to Task B */
-
-	SST_ISR_EXIT(pin, 0);
-}
-
-/*	~~~   Timer C interrupt handler   ~~~
-*	This function is called when the timerTC overflows.
-*	It posts a TICK_SIG to task C.
-*	~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-*/
-static void timerTC_ISR() {
-	uint8_t pin;
-	SST_ISR_ENTRY(pin, TICK_ISR_PRIO);
-
-	SST_post(TASK_C_PRIO, TICK_SIG, 0);     /* post the Tick to Task C */
+		//Do blinky stuff
+		if (GPIO_REG_READ(GPIO_OUT_ADDRESS) & BIT2)
+		{
+			//Set GPIO2 to LOW
+			gpio_output_set(0, BIT2, BIT2, 0);
+		}
+		else
+		{
+			//Set GPIO2 to HIGH
+			gpio_output_set(BIT2, 0, BIT2, 0);
+		}
+	}
 
 	SST_ISR_EXIT(pin, 0);
 }
@@ -196,6 +168,17 @@ void task_C(SSTEvent e) {
 	}
 }
 
+/*	~~~   Log task   ~~~
+*	Every second the log task, the lowest priority task, prints the kernel
+*	messages logged meanwhile, so no task waits for the UART.
+*	~~~~~~~~~~~~~~~~~~
+*/
+void task_log(SSTEvent e) {
+	if (e.sig == TICK_SIG) {
+		SST_logDrain(0xFF);
+	}
+}
+
 //Do nothing function
 /*
 static void ICACHE_FLASH_ATTR
@@ -223,19 +206,12 @@ user_init()
 
 	// Disarm timer - I think this is to create a timer reference and reset it
 	os_timer_disarm(&global_timer);
-	os_timer_disarm(&timerTA);
-	os_timer_disarm(&timerTC);
 
 	// Setup timer - Set ISRs calls to the specific timer
 	os_timer_setfn(&global_timer, (os_timer_func_t *)tickISR, NULL);
-	os_timer_setfn(&timerTA, (os_timer_func_t *)timerTA_ISR, NULL);
-	os_timer_setfn(&timerTC, (os_timer_func_t *)timerTC_ISR, NULL);
-
 
 	// Arm the timer - Configure timers with a specific value
-	os_timer_arm(&global_timer, 1000, 1);
-	os_timer_arm(&timerTA, 5000, 1);
-	os_timer_arm(&timerTC, 3000, 1);
+	os_timer_arm(&global_timer, 1000/TICKS_PER_SEC, 1);
 
 	// Initialize the semaphore
 	SST_initMailbox(&mb);
@@ -250,6 +226,17 @@ user_init()
 	// Task C is created
 	SST_task(&task_C, TASK_C_PRIO, taskCQueue, sizeof(taskCQueue)/sizeof(taskCQueue[0]), INIT_SIG, 0);
 
+	// Log task is created
+	SST_task(&task_log, LOG_TASK_PRIO, logTaskQueue, sizeof(logTaskQueue)/sizeof(logTaskQueue[0]), INIT_SIG, 0);
+
+	// Arm the time events - Periods in SST ticks
+	SST_timeEvtInit(&timeEvtA, TASK_A_PRIO, TICK_SIG, 0);
+	SST_timeEvtInit(&timeEvtC, TASK_C_PRIO, TICK_SIG, 0);
+	SST_timeEvtInit(&timeEvtLog, LOG_TASK_PRIO, TICK_SIG, 0);
+	SST_timeEvtArm(&timeEvtA, 50, 50);
+	SST_timeEvtArm(&timeEvtC, 30, 30);
+	SST_timeEvtArm(&timeEvtLog, TICKS_PER_SEC, TICKS_PER_SEC);
+
 	// Start SST scheduler
 	SST_run();
 
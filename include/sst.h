@@ -40,19 +40,177 @@ typedef uint16_t uintX_t;
 typedef uint32_t uintX_t;
 #elif SST_MAX_PRIO == 64
 typedef uint64_t uintX_t ;
+#elif (SST_MAX_PRIO == 128) || (SST_MAX_PRIO == 256)
+#define SST_PRIO_GROUPS  (SST_MAX_PRIO / 32)
+#else
+#error "SST_MAX_PRIO must be 8, 16, 32, 64, 128 or 256"
+#endif
+
+#include "sst_log2.h"                /* highest-priority lookup, SST_LOG2() */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: SSTPrioSet is the set of priorities used for the SST ready-set and for
+  the semaphore wait sets. Priority p (1..SST_MAX_PRIO) is bit (p - 1).
+  Up to 64 priorities the set is a single uintX_t word. With 128 or 256
+  priorities it becomes a bitmap of bitmaps: 'grp' has one bit per group of
+  32 priorities that has any member, and 'bits[g]' holds the group itself,
+  so finding the highest priority always takes exactly two lookups.
+  Priorities are uint8_t, so with SST_MAX_PRIO == 256 the usable task
+  priorities are 1..255 and should stay below the ISR priorities.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef SST_PRIO_GROUPS
+typedef uintX_t SSTPrioSet;
+
+static inline void SST_prioSetInsert(SSTPrioSet *s, uint8_t p) {
+    *s |= (uintX_t)((uintX_t)1 << (p - 1));
+}
+static inline void SST_prioSetRemove(SSTPrioSet *s, uint8_t p) {
+    *s &= (uintX_t)~((uintX_t)1 << (p - 1));
+}
+static inline uint8_t SST_prioSetFindMax(SSTPrioSet const *s) {
+    return SST_LOG2(*s);
+}
+static inline uint8_t SST_prioSetHas(SSTPrioSet const *s, uint8_t p) {
+    return (uint8_t)((*s >> (p - 1)) & 1U);
+}
+static inline uint8_t SST_prioSetIsEmpty(SSTPrioSet const *s) {
+    return (uint8_t)(*s == (uintX_t)0);
+}
+static inline void SST_prioSetClear(SSTPrioSet *s) {
+    *s = (uintX_t)0;
+}
+static inline void SST_prioSetUnion(SSTPrioSet *s, SSTPrioSet const *t) {
+    *s |= *t;
+}
+#else
+typedef struct SSTPrioSetTag SSTPrioSet;
+struct SSTPrioSetTag {
+    uint8_t  grp;                         /* groups with at least one member */
+    uint32_t bits[SST_PRIO_GROUPS];                  /* 32 priorities each */
+};
+
+static inline void SST_prioSetInsert(SSTPrioSet *s, uint8_t p) {
+    uint8_t b = (uint8_t)(p - 1);
+    s->grp |= (uint8_t)(1U << (b >> 5));
+    s->bits[b >> 5] |= (uint32_t)1 << (b & 0x1FU);
+}
+static inline void SST_prioSetRemove(SSTPrioSet *s, uint8_t p) {
+    uint8_t b = (uint8_t)(p - 1);
+    if ((s->bits[b >> 5] &= ~((uint32_t)1 << (b & 0x1FU))) == 0U) {
+        s->grp &= (uint8_t)~(1U << (b >> 5));   /* group became empty */
+    }
+}
+static inline uint8_t SST_prioSetFindMax(SSTPrioSet const *s) {
+    uint8_t g = SST_log2_8(s->grp);
+    if (g == (uint8_t)0) {
+        return (uint8_t)0;
+    }
+    --g;
+    return (uint8_t)((g << 5) + SST_log2_32(s->bits[g]));
+}
+static inline uint8_t SST_prioSetHas(SSTPrioSet const *s, uint8_t p) {
+    uint8_t b = (uint8_t)(p - 1);
+    return (uint8_t)((s->bits[b >> 5] >> (b & 0x1FU)) & 1U);
+}
+static inline uint8_t SST_prioSetIsEmpty(SSTPrioSet const *s) {
+    return (uint8_t)(s->grp == (uint8_t)0);
+}
+static inline void SST_prioSetClear(SSTPrioSet *s) {
+    uint8_t g;
+    s->grp = (uint8_t)0;
+    for (g = (uint8_t)0; g < (uint8_t)SST_PRIO_GROUPS; ++g) {
+        s->bits[g] = (uint32_t)0;
+    }
+}
+static inline void SST_prioSetUnion(SSTPrioSet *s, SSTPrioSet const *t) {
+    uint8_t g;
+    s->grp |= t->grp;
+    for (g = (uint8_t)0; g < (uint8_t)SST_PRIO_GROUPS; ++g) {
+        s->bits[g] |= t->bits[g];
+    }
+}
 #endif
 
 typedef uint8_t SSTSignal;
 typedef uint8_t SSTParam;
 
+#ifdef SST_DYN_POOLS
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Dynamic events (enabled by defining SST_DYN_POOLS, the number of event
+  pools, in sst_port.h) carry a pointer to a payload allocated from a
+  fixed-size event pool. The payload struct must start with SSTDynEvt:
+      typedef struct { SSTDynEvt super; uint8_t data[32]; } DataEvt;
+      DataEvt *d = (DataEvt *)SST_dynNew(sizeof(DataEvt));
+      SST_postDyn(TASK_B_PRIO, DATA_SIG, &d->super);
+  Every queued copy holds a reference and the kernel releases it after the
+  receiving task returns, so the block is recycled after the last receiver
+  has run. A producer that allocates an event and then does not post it
+  must release it with SST_dynGc().
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+typedef struct SSTDynEvtTag SSTDynEvt;
+struct SSTDynEvtTag {
+    uint8_t poolId__;             /* 1-based pool the block came from */
+    uint8_t refCtr__;             /* number of queued references */
+};
+#endif
+
 typedef struct SSTEventTag SSTEvent;
 struct SSTEventTag {
     SSTSignal sig;
     SSTParam  par;
+#ifdef SST_DYN_POOLS
+    SSTDynEvt *dyn;               /* dynamic payload or NULL */
+#endif
 };
 
 typedef void (*SSTTask)(SSTEvent e);
 
+typedef struct SSTPostTag SSTPost;                /* one SST_postBatch() item */
+struct SSTPostTag {
+    uint8_t   prio;
+    SSTSignal sig;
+    SSTParam  par;
+    uint8_t   ok;                       /* result, set by SST_postBatch() */
+};
+
+/* what SST_post() does when the task's queue is full, SST_taskOverflow() */
+enum SSTOverflow {
+    SST_OVF_REJECT_NEWEST,       /* the new event is lost, SST_post() -> 0 */
+    SST_OVF_DROP_OLDEST,            /* the oldest queued event is lost */
+    SST_OVF_COALESCE,   /* replaces the newest queued event with its signal */
+    SST_OVF_OVERWRITE_LATEST,       /* replaces the newest queued event */
+    SST_OVF_POLICIES
+};
+
+#ifdef SST_EVT_POOL
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: With SST_EVT_POOL the queue given to SST_task() is only the task's
+  guaranteed reserve. Events beyond it borrow nodes of one shared pool of
+  up to 254 nodes, registered with SST_evtPoolInit(), so the queues need not
+  all be sized for their worst bursts at once. Posting and dequeuing stay
+  O(1) and the overflow policies apply once both are full.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#define SST_EVT_NIL ((uint8_t)0xFF)
+
+typedef struct SSTEvtNodeTag SSTEvtNode;
+struct SSTEvtNodeTag {
+    SSTEvent e;
+    uint8_t next__;                  /* index of the next node in the list */
+};
+
+void SST_evtPoolInit(SSTEvtNode *nodes, uint8_t n);
+uint8_t SST_evtPoolUsed(void);
+uint8_t SST_evtPoolMaxUsed(void);
+uint16_t SST_evtPoolFails(void);
+#endif
+
 void SST_init(void);
 void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
               SSTSignal sig, SSTParam  par);
@@ -60,8 +218,56 @@ void SST_start(void);
 void SST_run(void);
 void SST_onIdle(void);
 void SST_exit(void);
+void SST_taskOverflow(uint8_t prio, uint8_t policy);
+uint16_t SST_overflowDrops(uint8_t policy);
 
 uint8_t SST_post(uint8_t prio, SSTSignal sig, SSTParam  par);
+uint8_t SST_postUrgent(uint8_t prio, SSTSignal sig, SSTParam par);
+uint8_t SST_postBatch(SSTPost *posts, uint8_t n);
+uint8_t SST_postMask(SSTPrioSet const *prios, SSTSignal sig, SSTParam par,
+                     SSTPrioSet *failed);
+
+/* publish-subscribe, signals below SST_MAX_SIG (see src/sst_ps.c) */
+#ifndef SST_MAX_SIG
+#define SST_MAX_SIG 32
+#endif
+void SST_subscribe(uint8_t prio, SSTSignal sig);
+void SST_unsubscribe(uint8_t prio, SSTSignal sig);
+uint8_t SST_publish(SSTSignal sig, SSTParam par);
+
+/* time events driven by SST_tick() (see src/sst_tev.c) */
+#ifndef SST_TEV_SLOTS_LOG2
+#define SST_TEV_SLOTS_LOG2 4                  /* timing wheel of 16 slots */
+#endif
+#define SST_TEV_SLOTS (1U << SST_TEV_SLOTS_LOG2)
+
+typedef struct SSTTimeEvtTag SSTTimeEvt;
+struct SSTTimeEvtTag {
+    SSTTimeEvt *next__;                  /* doubly linked in a wheel slot */
+    SSTTimeEvt *prev__;
+    SSTTimeEvt *due__;                 /* links the events due in a tick */
+    uint16_t rounds__;              /* wheel revolutions before expiring */
+    uint16_t interval__;                   /* period in ticks, 0: one-shot */
+    uint8_t slot__;                    /* wheel slot, 0xFF when disarmed */
+    uint8_t prio__;
+    SSTSignal sig__;
+    SSTParam par__;
+};
+
+void SST_timeEvtInit(SSTTimeEvt *te, uint8_t prio, SSTSignal sig,
+                     SSTParam par);
+void SST_timeEvtArm(SSTTimeEvt *te, uint16_t ticks, uint16_t interval);
+uint8_t SST_timeEvtDisarm(SSTTimeEvt *te);
+uint8_t SST_timeEvtRearm(SSTTimeEvt *te, uint16_t ticks);
+void SST_tick(void);
+void SST_tickAnnounce(uint16_t ticks);
+uint32_t SST_tickCount(void);
+uint16_t SST_timeEvtNextExpiry(void);
+
+#ifdef SST_TICKLESS
+void SST_tickless(void);          /* tickless idle, call from SST_onIdle() */
+uint16_t SST_onSleep(uint16_t ticks);         /* port low-power wait hook */
+#endif
 
 uint8_t SST_mutexLock(uint8_t prioCeiling);
 void SST_mutexUnlock(uint8_t orgPrio);
@@ -72,20 +278,51 @@ void SST_schedule_(void);
 #define SST_ISR_ENTRY(pin_, isrPrio_) do { \
     (pin_) = SST_currPrio_; \
     SST_currPrio_ = (isrPrio_); \
+    SST_TRACE_REC(SST_TRC_ISR_ENTRY, (isrPrio_), (pin_)); \
+    SST_STATS_ISR_(1); \
     SST_INT_UNLOCK(); \
 } while (0)
 
 #define SST_ISR_EXIT(pin_, EOI_command_) do { \
     SST_INT_LOCK(); \
     (EOI_command_); \
+    SST_TRACE_REC(SST_TRC_ISR_EXIT, SST_currPrio_, (pin_)); \
+    SST_STATS_ISR_(-1); \
     SST_currPrio_ = (pin_); \
     SST_schedule_(); \
 } while (0)
 
+// Definition of Memory pool
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: A memory pool is a statically allocated partition of fixed-size
+  blocks kept in a free list, so SST_memGet()/SST_memPut() are O(1) under the
+  interrupt lock and can be called from ISRs. The kernel allocates its own
+  objects (e.g. queue buffers) with SST_memAlloc() from up to SST_MEM_POOLS
+  partitions registered by the application with SST_memInit(), in ascending
+  order of block size, before the objects are created.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef SST_MEM_POOLS
+#define SST_MEM_POOLS 3
+#endif
+
+typedef struct mempool_ {
+  void *free__;                                  /* head of the free list */
+  uint8_t *start__;                       /* the partition, for SST_memFree */
+  uint8_t *end__;
+  uint16_t blockSize__;
+  uint16_t nTot__;
+  uint16_t nFree__;
+  uint16_t nMin__;                             /* low-water mark of nFree__ */
+  uint16_t nFail__;       /* failed SST_memGet() and SST_memAlloc() calls */
+} SSTMemPool;
+
 // Definition of Semaphore
 typedef struct semaphore_ {
-	uint8_t c;
-	uintX_t queue;
+	uint8_t c;                  // available tokens
+	uint8_t max;                // maximum count, 1 for a binary semaphore
+	SSTPrioSet queue;           // tasks waiting on the semaphore
+	SSTPrioSet granted;         // tasks handed a token by SST_signal()
 } Semaphore;
 
 // Definition of Mailbox
@@ -102,14 +339,67 @@ typedef struct queue_ {
 	uint8_t tail;
 	uint8_t nelem;
 	uint8_t size;
+  uint8_t elemSize;           // bytes per element
+  uint8_t mask;               // size - 1 when size is a power of two, else 0
 } Queue;
 
+// Function definitions for Memory pool
+void SST_memPoolInit(SSTMemPool *mp, void *storage, uint16_t storageSize,
+                     uint16_t blockSize);
+
+void *SST_memGet(SSTMemPool *mp);
+
+void SST_memPut(SSTMemPool *mp, void *block);
+
+void *SST_memGet_(SSTMemPool *mp);              /* interrupts must be locked */
+
+void SST_memPut_(SSTMemPool *mp, void *block);  /* interrupts must be locked */
+
+uint16_t SST_memPoolFree(SSTMemPool const *mp);
+
+uint16_t SST_memPoolMinFree(SSTMemPool const *mp);
+
+uint16_t SST_memPoolFails(SSTMemPool const *mp);
+
+uint8_t SST_memInit(void *storage, uint16_t storageSize, uint16_t blockSize);
+
+void *SST_memAlloc(uint16_t size);
+
+void SST_memFree(void *block);
+
+SSTMemPool const *SST_memPartition(uint8_t id);
+
+#ifdef SST_DYN_POOLS
+// Function definitions for dynamic events
+uint8_t SST_dynPoolInit(void *storage, uint16_t storageSize,
+                        uint16_t blockSize);
+
+SSTDynEvt *SST_dynNew(uint16_t size);
+
+void SST_dynGc(SSTDynEvt *e);
+
+void SST_dynGc_(SSTDynEvt *e);                 /* interrupts must be locked */
+
+uint8_t SST_postDyn(uint8_t prio, SSTSignal sig, SSTDynEvt *dyn);
+
+uint8_t SST_multicastDyn(SSTPrioSet const *prios, SSTSignal sig,
+                         SSTDynEvt *dyn);
+
+uint16_t SST_dynPoolUsed(uint8_t poolId);
+
+uint16_t SST_dynPoolMaxUsed(uint8_t poolId);
+
+SSTMemPool const *SST_dynPool(uint8_t poolId);
+#endif
+
 // Function definitions for Semaphore
 void SST_initSemaphore(Semaphore *s);
 
+void SST_initSemCounting(Semaphore *s, uint8_t count, uint8_t max);
+
 uint8_t SST_wait(Semaphore *s);
 
-void SST_signal(Semaphore *s);
+uint8_t SST_signal(Semaphore *s);
 
 // Function definitions for Mailbox
 void SST_initMailbox(Mailbox *mb);
@@ -119,14 +409,134 @@ uint8_t SST_send(Mailbox *mb, uint8_t *data);
 uint8_t SST_receive(Mailbox *mb, uint8_t *data);
 
 // Function definitions for Queue
-void SST_initQueue(Queue *q, uint8_t size);
+uint8_t SST_initQueue(Queue *q, uint8_t size);
+
+uint8_t SST_initQueueElem(Queue *q, uint8_t size, uint8_t elemSize);
 
+void SST_freeQueue(Queue *q);
+
+// SST_enqueue/SST_dequeue move one byte and need elemSize == 1
 uint8_t SST_enqueue(Queue *q, uint8_t data);
 
 uint8_t SST_dequeue(Queue *q, uint8_t *data);
 
+uint8_t SST_enqueueN(Queue *q, void const *elems, uint8_t n);
+
+uint8_t SST_dequeueN(Queue *q, void *elems, uint8_t n);
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: SSTKernel holds the state of one scheduler: the current priority,
+  the ready set, the task control blocks and the timing wheel, and with
+  several kernels the subscriber lists, which a single kernel keeps in
+  src/sst_ps.c so that only the images using publish-subscribe pay for
+  them. The kernel API works on the current kernel SST_kernel_,
+  which is the statically allocated SST_kernel0_, so a single kernel costs
+  the same as plain globals. A port for several cores defines
+  SST_MAX_KERNELS above 1 and SST_KERNEL_TLS, the storage class of a
+  per-thread variable. SST_kernel_ then points to the kernel of the calling
+  thread, set with SST_kernelBind(), and every core runs its own tasks and
+  priorities under its own interrupt lock. The kernels share no state: a
+  task posts to a task of another kernel with SST_postTo(), which goes
+  through the lock-free inbox of the receiving kernel, and the port's
+  SST_onInbox() wakes that kernel to run SST_inboxDrain(). The memory
+  pools, dynamic events, log, trace, statistics and stack profile stay
+  process-wide and must be used from one kernel only.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef SST_MAX_KERNELS
+#define SST_MAX_KERNELS 1
+#endif
+
+typedef struct SSTTaskCBTag SSTTaskCB;
+struct SSTTaskCBTag {               /* widest fields first, no padding holes */
+    SSTTask task__;
+    SSTEvent *queue__;
+    SSTEvent lastEvent__;                /* used when task is "suspended" */
+    uint8_t end__;                               /* the length of the queue */
+    uint8_t head__;
+    uint8_t tail__;
+    uint8_t nUsed__;
+    uint8_t wake__;           /* semaphore wakeups pending (SIGNAL_SEM_SIG) */
+    uint8_t ovf__;                     /* overflow policy of the full queue */
+#ifdef SST_EVT_POOL
+    uint8_t first__;                  /* pool nodes borrowed, oldest first */
+    uint8_t last__;
+#endif
+};
+
+#if SST_MAX_KERNELS > 1
+typedef struct SSTInboxMsgTag SSTInboxMsg;     /* one SST_postTo() in flight */
+struct SSTInboxMsgTag {
+    uint32_t seq__;                    /* the slot's turn, see src/sst_smp.c */
+    uint8_t prio;
+    SSTSignal sig;
+    SSTParam par;
+};
+#endif
+
+typedef struct SSTKernelTag SSTKernel;
+struct SSTKernelTag {
+    uint8_t currPrio__;           /* current priority of the executing task */
+    SSTPrioSet readySet__;
+#ifdef SST_MAX_TASKS
+    SSTTaskCB taskCB__[SST_MAX_TASKS + 1];  /* [0] is a block without a task */
+    uint8_t taskIdx__[SST_MAX_PRIO];           /* priority -> taskCB__[] */
+    uint8_t nTasks__;
+#else
+    SSTTaskCB taskCB__[SST_MAX_PRIO];
+#endif
+#if SST_MAX_KERNELS > 1
+    SSTPrioSet subscr__[SST_MAX_SIG];       /* subscribers of each signal */
+#endif
+    SSTTimeEvt *wheel__[SST_TEV_SLOTS];
+    uint32_t tickCtr__;
+    uint8_t cursor__;                          /* the slot of the last tick */
+    uint16_t ovfDrops__[SST_OVF_POLICIES];    /* events lost, per policy */
+#ifdef SST_EVT_POOL
+    SSTEvtNode *evtNode__;              /* the shared pool of event nodes */
+    uint8_t evtFree__;                            /* free list of the pool */
+    uint8_t evtUsed__;
+    uint8_t evtMaxUsed__;
+    uint16_t evtFails__;
+#endif
+#if SST_MAX_KERNELS > 1
+    uint8_t id__;                                /* for the port, 0.. */
+    SSTInboxMsg *inbox__;
+    uint32_t inboxMask__;                                 /* capacity - 1 */
+    uint32_t inboxTail__;                     /* read by this kernel only */
+    uint32_t inboxHead__ __attribute__((aligned(64)));  /* the posters' */
+    uint32_t inboxDrops__;
+#endif
+};
+
+#if SST_MAX_KERNELS > 1
+void SST_kernelInit(SSTKernel *k, uint8_t id);
+void SST_kernelBind(SSTKernel *k);      /* the calling thread's kernel */
+void SST_inboxInit(SSTKernel *k, SSTInboxMsg *storage, uint16_t capacity);
+uint8_t SST_postTo(SSTKernel *k, uint8_t prio, SSTSignal sig, SSTParam par);
+uint16_t SST_inboxDrain(void);
+uint8_t SST_inboxPending(SSTKernel const *k);
+uint32_t SST_inboxDrops(SSTKernel const *k);
+void SST_onInbox(SSTKernel *k);     /* port hook, wakes the kernel 'k' */
+#endif
+
 /* public-scope objects */
-extern uint8_t SST_currPrio_;     /* current priority of the executing task */
-extern uintX_t SST_readySet_;                              /* SST ready-set */
+extern SSTKernel SST_kernel0_;                         /* the first kernel */
+#if SST_MAX_KERNELS > 1
+extern SST_KERNEL_TLS SSTKernel *SST_kernel_;
+#else
+#define SST_kernel_      (&SST_kernel0_)
+#endif
+#define SST_currPrio_    (SST_kernel_->currPrio__)
+#define SST_readySet_    (SST_kernel_->readySet__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "sst_trace.h"           /* kernel trace, SST_TRACE_REC() records */
+#include "sst_log.h"                /* deferred logging, SST_LOG() messages */
+#include "sst_stats.h"                 /* runtime statistics, SST_getStats() */
+#include "sst_stack.h"                  /* single-stack depth profiling */
 
 #endif                                                             /* sst_h */
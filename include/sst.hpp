@@ -0,0 +1,155 @@
+/*****************************************************************************
+* SST C++17 front end
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: This header-only layer puts types on top of the C kernel and costs
+  nothing at run time. sst::Signal<SIG, Payload> binds a signal number to the
+  type carried in SSTEvent.par, sst::On<Signal, handler> binds it to a
+  handler taking that type (or nothing), and sst::Task<PRIO, On...> is a
+  task whose dispatch() is the SSTTask given to SST_task():
+
+      using Tick  = sst::Signal<TICK_SIG, uint8_t>;
+      using Color = sst::Signal<COLOR_SIG, Hue>;        // enum Hue : uint8_t
+      using Blinky = sst::Task<TASK_A_PRIO, sst::On<Tick, &onTick>,
+                                            sst::On<Color, &onColor>>;
+      Blinky::start<Init>(queue);
+      Blinky::post<Tick>(3);       // Blinky::post<Kbd>() does not compile
+
+  The signal-to-handler table exists at compile time only. dispatch() is
+  unrolled from it into one compare per signal with the handler inlined,
+  which the compiler lowers to the same compare chain or jump table as the
+  hand-written 'if (e.sig == ...)' tasks (bench/cpp_bench.cpp). A table of
+  handler pointers would add an indirect call and the handler thunks.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#ifndef sst_hpp
+#define sst_hpp
+
+#include "sst_port.h"     /* a host port's sst_port.h, if included first */
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace sst {
+
+namespace detail {
+
+template <typename P>
+constexpr bool fits() {
+    if constexpr (std::is_void_v<P>) {
+        return true;
+    }
+    else {
+        return std::is_trivially_copyable_v<P>
+               && (sizeof(P) <= sizeof(SSTParam));
+    }
+}
+template <typename P>
+inline SSTParam encode(P p) {
+    SSTParam par = SSTParam();
+    std::memcpy(&par, &p, sizeof(P));
+    return par;
+}
+template <typename P>
+inline P decode(SSTParam par) {
+    P p;
+    std::memcpy(&p, &par, sizeof(P));
+    return p;
+}
+template <typename Sig>
+inline SSTParam param() {
+    static_assert(std::is_void_v<typename Sig::Payload>,
+                  "the signal carries a payload");
+    return SSTParam();
+}
+template <typename Sig, typename A>
+inline SSTParam param(A a) {
+    static_assert(!std::is_void_v<typename Sig::Payload>,
+                  "the signal carries no payload");
+    return encode<typename Sig::Payload>(
+        static_cast<typename Sig::Payload>(a));
+}
+
+} // namespace detail
+
+template <SSTSignal S, typename P = void>
+struct Signal {
+    static constexpr SSTSignal sig = S;
+    using Payload = P;
+    static_assert(detail::fits<P>(),
+                  "the payload of a signal must fit SSTParam");
+};
+
+template <typename Sig, auto Fn>
+struct On {
+    using Signal = Sig;
+    static inline void call(SSTParam par) {
+        if constexpr (std::is_void_v<typename Sig::Payload>) {
+            static_assert(std::is_invocable_v<decltype(Fn)>,
+                          "the handler must take no arguments");
+            Fn();
+        }
+        else {
+            static_assert(std::is_invocable_v<decltype(Fn),
+                                               typename Sig::Payload>,
+                          "the handler must take the signal's payload");
+            Fn(detail::decode<typename Sig::Payload>(par));
+        }
+    }
+};
+
+template <uint8_t Prio, typename... Hs>
+class Task {
+    template <SSTSignal S>
+    static constexpr unsigned count_ = ((Hs::Signal::sig == S) + ... + 0U);
+
+public:
+    static constexpr uint8_t prio = Prio;
+
+    static_assert((Prio >= 1U) && (Prio <= SST_MAX_PRIO),
+                  "the priority must be in 1..SST_MAX_PRIO");
+    static_assert(((count_<Hs::Signal::sig> == 1U) && ...),
+                  "a signal can have only one handler");
+
+    template <typename Sig>
+    static constexpr bool accepts =
+        (std::is_same_v<typename Hs::Signal, Sig> || ...);
+
+    static void dispatch(SSTEvent e) {                   /* the SSTTask */
+        (void)(((e.sig == Hs::Signal::sig) ? (Hs::call(e.par), true)
+                                            : false) || ...);
+    }
+
+    template <typename Init, std::size_t N, typename... A>
+    static void start(SSTEvent (&queue)[N], A... a) {
+        static_assert(N <= 0xFFU, "the queue length must fit uint8_t");
+        SST_task(&dispatch, Prio, queue, static_cast<uint8_t>(N), Init::sig,
+                 detail::param<Init>(a...));
+    }
+
+    template <typename Sig, typename... A>
+    static uint8_t post(A... a) {
+        static_assert(accepts<Sig>, "the task does not handle this signal");
+        return SST_post(Prio, Sig::sig, detail::param<Sig>(a...));
+    }
+
+    template <typename Sig, typename... A>
+    static uint8_t postUrgent(A... a) {
+        static_assert(accepts<Sig>, "the task does not handle this signal");
+        return SST_postUrgent(Prio, Sig::sig, detail::param<Sig>(a...));
+    }
+};
+
+} // namespace sst
+
+#endif                                                           /* sst_hpp */
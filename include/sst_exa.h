@@ -31,6 +31,7 @@ enum Events {                         /* the events used in the application */
 
 enum SSTPriorities {     /* the SST priorities don't need to be consecutive */
     /* task priorities... */
+    LOG_TASK_PRIO = 1,                      /* drains the deferred log */
     TASK_A_PRIO = 2,
     // KBD_TASK_PRIO    = 5,
     TASK_B_PRIO = 6,
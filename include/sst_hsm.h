@@ -0,0 +1,108 @@
+/*****************************************************************************
+* SST table-driven hierarchical state machines
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: A machine is described by constant tables: the states with their
+  superstate, initial substate and entry/exit actions, and the transitions
+  with their source state, signal, target and action. A substate inherits
+  every transition of its superstates that it does not override.
+  SST_hsmInit() resolves the tables once into a workspace: for every leaf
+  state and signal a cell with the transition that handles it and the
+  precomputed list of the states to exit and to enter (down to the target
+  and through its initial transitions). SST_hsmDispatch() then costs one
+  lookup plus the actions on that path, however deep the hierarchy and
+  however many signals the superstates handle; unhandled signals cost the
+  lookup only.
+  The transitions are external: a self-transition exits and re-enters its
+  source, a transition to a superstate exits and re-enters the superstate,
+  and a transition to a substate does not leave the source. A transition
+  without a target (SST_HSM_NONE) is internal, only its action runs. The
+  first event a machine gets, normally the initialization event of
+  SST_task(), takes its initial transition. Include this file after
+  sst_port.h.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef sst_hsm_h
+#define sst_hsm_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SST_HSM_NONE  ((uint8_t)0xFF)      /* no state, top or no target */
+
+typedef void (*SSTHsmAction)(void *ctx, SSTEvent const *e);
+
+typedef struct SSTHsmStateTag SSTHsmState;
+struct SSTHsmStateTag {
+    uint8_t super;                  /* superstate, SST_HSM_NONE at the top */
+    uint8_t init;       /* substate of the initial transition, or NONE */
+    SSTHsmAction entry;                                  /* optional */
+    SSTHsmAction exit;                                   /* optional */
+};
+
+typedef struct SSTHsmTranTag SSTHsmTran;
+struct SSTHsmTranTag {
+    uint8_t source;
+    SSTSignal sig;
+    uint8_t target;                        /* SST_HSM_NONE: internal */
+    SSTHsmAction action;                                 /* optional */
+};
+
+typedef struct SSTHsmDefTag SSTHsmDef;
+struct SSTHsmDefTag {
+    SSTHsmState const *states;                  /* indexed by the state */
+    SSTHsmTran const *trans;
+    uint8_t nStates;                                    /* up to 254 */
+    uint8_t nTrans;                                     /* up to 254 */
+    uint8_t init;                         /* the top initial transition */
+    SSTSignal nSigs;                  /* signals 0..nSigs-1 are handled */
+};
+
+typedef struct SSTHsmCellTag SSTHsmCell;
+struct SSTHsmCellTag {            /* a leaf state and a signal, resolved */
+    uint16_t path;                 /* the exits and entries in path__[] */
+    uint8_t tran;                   /* trans[] index, NONE for the start */
+    uint8_t nExit;
+    uint8_t nEntry;
+    uint8_t leaf;                             /* the state afterwards */
+};
+
+typedef struct SSTHsmTag SSTHsm;
+struct SSTHsmTag {
+    SSTHsmDef const *def__;
+    void *ctx__;                               /* passed to the actions */
+    SSTHsmCell *cell__;                    /* cell__[0] is the start */
+    uint8_t *lut__;                  /* [state * nSigs + sig] -> cell */
+    uint8_t *path__;
+    uint8_t state__;               /* leaf, SST_HSM_NONE until started */
+};
+
+uint16_t SST_hsmWorkSize(SSTHsmDef const *def);
+uint8_t SST_hsmInit(SSTHsm *me, SSTHsmDef const *def, void *ctx,
+                    void *work, uint16_t workSize);
+void SST_hsmDispatch(SSTHsm *me, SSTEvent const *e);
+
+static inline uint8_t SST_hsmState(SSTHsm const *me) {
+    return me->state__;
+}
+
+                       /* defines the SSTTask that runs the machine 'hsm_' */
+#define SST_HSM_TASK(task_, hsm_) \
+    void task_(SSTEvent e) { \
+        SST_hsmDispatch(&(hsm_), &e); \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                         /* sst_hsm_h */
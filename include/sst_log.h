@@ -0,0 +1,112 @@
+/*****************************************************************************
+* SST deferred logging
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: A log call does not format anything. It stores the message ID and two
+  raw arguments (8 bytes) in an SSTRing, which takes a few stores inside the
+  critical section the kernel already holds. The messages are formatted
+  later, outside any lock, by SST_logDrain() called from the lowest-priority
+  task, or sent raw with SST_logDrainRaw() and formatted on the host by
+  tools/sst_log.py, which reads the message table below from this header.
+  Every message has a level; the calls of the messages above SST_LOG_LEVEL
+  compile to nothing, and SST_LOG_LEVEL == SST_LOG_OFF removes the log.
+  The application adds its messages by defining SST_LOG_APP_MSGS(X_) the
+  same way before including sst.h.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#ifndef sst_log_h
+#define sst_log_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SST_LOG_OFF    0
+#define SST_LOG_ERROR  1
+#define SST_LOG_WARN   2
+#define SST_LOG_INFO   3
+#define SST_LOG_DEBUG  4
+
+#ifndef SST_LOG_LEVEL
+#define SST_LOG_LEVEL  SST_LOG_WARN
+#endif
+
+              /* message table: ID, level, format with up to two %u/%d/%x */
+#define SST_LOG_MSGS(X_) \
+    X_(SST_LOG_DROPPED,  SST_LOG_ERROR, "%u log records dropped") \
+    X_(SST_LOG_POST_FAIL, SST_LOG_WARN, "queue of task %u full, signal %u lost") \
+    X_(SST_LOG_MB_FULL,  SST_LOG_DEBUG, "mailbox is full, task %u waits") \
+    X_(SST_LOG_MB_EMPTY, SST_LOG_DEBUG, "no data in the mailbox, task %u waits") \
+    X_(SST_LOG_Q_FULL,   SST_LOG_DEBUG, "no more space in the queue, task %u waits") \
+    X_(SST_LOG_Q_EMPTY,  SST_LOG_DEBUG, "no data in the queue, task %u waits") \
+    X_(SST_LOG_SEM_WAKE, SST_LOG_DEBUG, "task %u woken by a semaphore") \
+    X_(SST_LOG_NO_TCB,   SST_LOG_ERROR, "no control block for task %u, SST_MAX_TASKS is %u")
+
+#ifndef SST_LOG_APP_MSGS
+#define SST_LOG_APP_MSGS(X_)
+#endif
+
+#define SST_LOG_ID_(id_, lvl_, fmt_)   id_,
+#define SST_LOG_LVL_(id_, lvl_, fmt_)  id_##_LVL = (lvl_),
+enum SSTLogMsgs {
+    SST_LOG_MSGS(SST_LOG_ID_)
+    SST_LOG_APP_MSGS(SST_LOG_ID_)
+    SST_LOG_N_MSGS
+};
+enum SSTLogLevels {
+    SST_LOG_MSGS(SST_LOG_LVL_)
+    SST_LOG_APP_MSGS(SST_LOG_LVL_)
+    SST_LOG_N_LVLS
+};
+
+#if SST_LOG_LEVEL > SST_LOG_OFF
+
+typedef struct SSTLogRecTag SSTLogRec;
+struct SSTLogRecTag {
+    uint8_t  id;                                          /* SSTLogMsgs */
+    uint8_t  reserved;
+    uint16_t a;
+    uint32_t b;
+};
+
+typedef void (*SSTLogOut)(void const *data, uint16_t len);
+
+void SST_logPut_(uint8_t id, uint16_t a, uint32_t b);
+void SST_logPut(uint8_t id, uint16_t a, uint32_t b);
+uint8_t SST_logDrain(uint8_t max);
+uint8_t SST_logDrainRaw(SSTLogOut out, uint8_t max);
+uint16_t SST_logDropped(void);
+
+                              /* SST_LOG_() with interrupts LOCKED only */
+#define SST_LOG_(id_, a_, b_) do { \
+    if (id_##_LVL <= SST_LOG_LEVEL) { \
+        SST_logPut_((uint8_t)(id_), (uint16_t)(a_), (uint32_t)(b_)); \
+    } \
+} while (0)
+#define SST_LOG(id_, a_, b_) do { \
+    if (id_##_LVL <= SST_LOG_LEVEL) { \
+        SST_logPut((uint8_t)(id_), (uint16_t)(a_), (uint32_t)(b_)); \
+    } \
+} while (0)
+
+#else                                                     /* SST_LOG_OFF */
+
+#define SST_LOG_(id_, a_, b_)  ((void)0)
+#define SST_LOG(id_, a_, b_)   ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                         /* sst_log_h */
@@ -0,0 +1,105 @@
+/*****************************************************************************
+* SST highest-priority lookup
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: All functions below return the 1-based number of the most significant
+  set bit (bit 0 -> 1, bit 31 -> 32) or 0 when no bit is set, which is
+  exactly the priority encoding of the SST ready-set.
+  Two engines are provided. The count-leading-zeros engine relies on the
+  compiler builtins and is used when the target has a native instruction.
+  The table engine needs at most three compares and one lookup in a 256-byte
+  table, and it is the default for the ESP8266 (LX106 has no NSAU, so
+  __builtin_clz() would become a libgcc call). A port can force either
+  engine by defining SST_LOG2_CLZ to 0 or 1 before including sst.h.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#ifndef sst_log2_h
+#define sst_log2_h
+
+#include <stdint.h>                 /* exact-width integer types, ANSI C'99 */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SST_LOG2_CLZ
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__) \
+    || defined(__aarch64__) || defined(__ARM_FEATURE_CLZ))
+#define SST_LOG2_CLZ 1
+#else
+#define SST_LOG2_CLZ 0
+#endif
+#endif
+
+extern uint8_t const SST_log2Lkup_[256];        /* log2 of a byte, plus 1 */
+
+/* table engine ............................................................*/
+static inline uint8_t SST_log2Tbl8(uint8_t x) {
+    return SST_log2Lkup_[x];
+}
+static inline uint8_t SST_log2Tbl16(uint16_t x) {
+    return ((x & 0xFF00U) != 0U)
+           ? (uint8_t)(SST_log2Lkup_[x >> 8] + 8U)
+           : SST_log2Lkup_[x];
+}
+static inline uint8_t SST_log2Tbl32(uint32_t x) {
+    if ((x & 0xFFFF0000U) != 0U) {
+        return ((x & 0xFF000000U) != 0U)
+               ? (uint8_t)(SST_log2Lkup_[x >> 24] + 24U)
+               : (uint8_t)(SST_log2Lkup_[(x >> 16) & 0xFFU] + 16U);
+    }
+    return ((x & 0x0000FF00U) != 0U)
+           ? (uint8_t)(SST_log2Lkup_[x >> 8] + 8U)
+           : SST_log2Lkup_[x];
+}
+static inline uint8_t SST_log2Tbl64(uint64_t x) {
+    uint32_t hi = (uint32_t)(x >> 32);                /* no 64-bit compare */
+    return (hi != 0U)
+           ? (uint8_t)(SST_log2Tbl32(hi) + 32U)
+           : SST_log2Tbl32((uint32_t)x);
+}
+
+/* selected engine .........................................................*/
+#if SST_LOG2_CLZ
+static inline uint8_t SST_log2_32(uint32_t x) {
+    return (x != 0U) ? (uint8_t)(32 - __builtin_clz((unsigned int)x)) : 0U;
+}
+static inline uint8_t SST_log2_64(uint64_t x) {
+    return (x != 0U)
+           ? (uint8_t)(64 - __builtin_clzll((unsigned long long)x))
+           : 0U;
+}
+#define SST_log2_8(x_)   SST_log2Tbl8(x_)   /* one load beats clz+subtract */
+#define SST_log2_16(x_)  SST_log2_32((uint32_t)(x_))
+#else
+#define SST_log2_8(x_)   SST_log2Tbl8(x_)
+#define SST_log2_16(x_)  SST_log2Tbl16(x_)
+#define SST_log2_32(x_)  SST_log2Tbl32(x_)
+#define SST_log2_64(x_)  SST_log2Tbl64(x_)
+#endif
+
+                   /* lookup specialized for the ready-set width (uintX_t) */
+#if SST_MAX_PRIO == 8
+#define SST_LOG2(rs_)    SST_log2_8(rs_)
+#elif SST_MAX_PRIO == 16
+#define SST_LOG2(rs_)    SST_log2_16(rs_)
+#elif SST_MAX_PRIO == 32
+#define SST_LOG2(rs_)    SST_log2_32(rs_)
+#elif SST_MAX_PRIO == 64
+#define SST_LOG2(rs_)    SST_log2_64(rs_)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* sst_log2_h */
@@ -22,10 +22,36 @@
 #define SST_INT_UNLOCK() ets_intr_unlock()
                                                /* maximum SST task priority */
 #define SST_MAX_PRIO     32
+                         /* control blocks for the tasks, see src/sst.c */
+#ifndef SST_MAX_TASKS
+#define SST_MAX_TASKS    8
+#endif
+
+#include "c_types.h"                          /* ESP8266 SDK basic types */
+#include "osapi.h"                                          /* os_printf() */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+                  /* cycle counter for the kernel trace and statistics */
+static inline uint32_t SST_cycles_(void) {
+    uint32_t ccount;
+    __asm__ __volatile__ ("rsr %0, ccount" : "=a" (ccount));
+    return ccount;
+}
+#define SST_CYCLES()     SST_cycles_()
+#ifndef SST_CYCLES_HZ
+#define SST_CYCLES_HZ    80000000U        /* 160000000U at the 160MHz clock */
+#endif
 
 //#include <dos.h>                  /* for declarations of disable()/enable() */
 //#undef outportb /*don't use the macro because it has a bug in Turbo C++ 1.01*/
 
 #include "sst.h"                      /* SST platform-independent interface */
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif                                                        /* sst_port_h */
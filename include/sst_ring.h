@@ -0,0 +1,124 @@
+/*****************************************************************************
+* SST single-producer/single-consumer ring buffer
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: SSTRing streams fixed-size elements from exactly one producer (e.g.
+  a UART RX or ADC ISR) to exactly one consumer task without locking
+  interrupts. The producer only writes 'head' and the consumer only writes
+  'tail'; both are free-running 16-bit counters, so the capacity must be a
+  power of two not larger than 32768. Each side copies the element before
+  (push) or after (pop) publishing its index, with SST_MEM_BARRIER() in
+  between. On a single core a compiler barrier is enough, a port for a
+  multi-core host defines SST_MEM_BARRIER() as an acquire/release fence and
+  SST_MEM_FULL_BARRIER() (store-load, used only with notification) as a
+  full fence.
+  With SST_ringNotify() the producer posts 'sig' to the consumer's priority
+  when its push makes the ring non-empty. On that event the consumer must
+  pop until the ring is empty; it may occasionally get a spurious event.
+  Include this file after sst_port.h.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef sst_ring_h
+#define sst_ring_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SST_MEM_BARRIER
+#define SST_MEM_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#endif
+#ifndef SST_MEM_FULL_BARRIER
+#define SST_MEM_FULL_BARRIER() SST_MEM_BARRIER()
+#endif
+
+typedef struct SSTRingTag SSTRing;
+struct SSTRingTag {
+    uint8_t *buf__;
+    uint16_t mask__;                                      /* capacity - 1 */
+    uint8_t elemSize__;
+    uint8_t notifyPrio__;                     /* 0 means no notification */
+    SSTSignal notifySig__;
+    volatile uint16_t head__;                 /* written by the producer */
+    volatile uint16_t tail__;                 /* written by the consumer */
+};
+
+/*..........................................................................*/
+static inline void SST_ringInit(SSTRing *r, void *storage, uint16_t capacity,
+                                uint8_t elemSize)
+{
+    r->buf__ = (uint8_t *)storage;
+    r->mask__ = (uint16_t)(capacity - 1U);
+    r->elemSize__ = elemSize;
+    r->notifyPrio__ = (uint8_t)0;
+    r->notifySig__ = (SSTSignal)0;
+    r->head__ = (uint16_t)0;
+    r->tail__ = (uint16_t)0;
+}
+/*..........................................................................*/
+static inline void SST_ringNotify(SSTRing *r, uint8_t prio, SSTSignal sig) {
+    r->notifySig__ = sig;
+    r->notifyPrio__ = prio;
+}
+/*..........................................................................*/
+static inline uint16_t SST_ringCount(SSTRing const *r) {
+    return (uint16_t)(r->head__ - r->tail__);
+}
+/*..........................................................................*/
+/* producer side, returns 0 when the ring is full */
+static inline uint8_t SST_ringPush(SSTRing *r, void const *elem) {
+    uint16_t head = r->head__;
+    uint8_t const *src = (uint8_t const *)elem;
+    uint8_t *dst;
+    uint8_t n;
+    if ((uint16_t)(head - r->tail__) > r->mask__) {
+        return (uint8_t)0;                                        /* full */
+    }
+    SST_MEM_BARRIER();              /* the free slot before writing it */
+    dst = &r->buf__[(uint16_t)(head & r->mask__) * r->elemSize__];
+    for (n = r->elemSize__; n != (uint8_t)0; --n) {
+        *dst++ = *src++;
+    }
+    SST_MEM_BARRIER();                  /* the element before the index */
+    r->head__ = (uint16_t)(head + 1U);
+    if (r->notifyPrio__ != (uint8_t)0) {
+        SST_MEM_FULL_BARRIER();      /* the index before reading 'tail' */
+        if ((uint16_t)(head + 1U - r->tail__) == (uint16_t)1) {
+            SST_post(r->notifyPrio__, r->notifySig__, (SSTParam)0);
+        }
+    }
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+/* consumer side, returns 0 when the ring is empty */
+static inline uint8_t SST_ringPop(SSTRing *r, void *elem) {
+    uint16_t tail = r->tail__;
+    uint8_t const *src;
+    uint8_t *dst = (uint8_t *)elem;
+    uint8_t n;
+    if (tail == r->head__) {
+        return (uint8_t)0;                                       /* empty */
+    }
+    SST_MEM_BARRIER();              /* the index before the element */
+    src = &r->buf__[(uint16_t)(tail & r->mask__) * r->elemSize__];
+    for (n = r->elemSize__; n != (uint8_t)0; --n) {
+        *dst++ = *src++;
+    }
+    SST_MEM_BARRIER();         /* done reading before the slot is freed */
+    r->tail__ = (uint16_t)(tail + 1U);
+    return (uint8_t)1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* sst_ring_h */
@@ -0,0 +1,97 @@
+/*****************************************************************************
+* SST single-stack profiling
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: All SST tasks share one stack, and its peak is set by the deepest
+  chain of nested preemptions. With SST_STACK_PROF defined the scheduler
+  samples the stack pointer (SST_STACK_SP()) at every dispatch and keeps, per
+  priority, the deepest point at which the task was started, together with
+  the maximum number of nested tasks and the chain of priorities that
+  reached the overall peak. The depths are measured from the highest frame
+  a task was ever dispatched from with no other task running: SST_run() at
+  first, but on the ESP8266 SST_run() returns and the later dispatches come
+  from SDK timer callbacks, whose frames can sit above it. The stack is
+  assumed to grow downwards, as on the ESP8266 and the hosts.
+  The dispatch samples miss what a task uses itself; SST_stackPaint() fills
+  the free stack with a pattern and SST_stackHighWater() finds the lowest
+  byte ever written, which covers the tasks and the ISRs as well.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#ifndef sst_stack_h
+#define sst_stack_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SST_STACK_PROF
+
+#ifndef SST_STACK_SP
+#define SST_STACK_SP()  ((uint8_t *)__builtin_frame_address(0))
+#endif
+
+typedef struct SSTStackProfTag SSTStackProf;
+struct SSTStackProfTag {
+    uint16_t maxDepth[SST_MAX_PRIO];   /* bytes below SST_run() at dispatch */
+    uint16_t peakDepth;                         /* the deepest of maxDepth */
+    uint8_t  maxNest;                     /* most tasks nested at a time */
+    uint8_t  peakLen;                     /* priorities in peakChain */
+    uint8_t  peakChain[SST_MAX_PRIO];     /* nested tasks at peakDepth */
+};
+
+void SST_stackPaint(void *lo);
+uint32_t SST_stackHighWater(void);
+void SST_stackReport(void);
+
+extern SSTStackProf SST_stackProf_;
+extern uint8_t *SST_stackBase_;      /* the highest SP of a dispatch */
+extern uint8_t SST_stackNest_;                 /* tasks running nested */
+extern uint8_t SST_stackChain_[SST_MAX_PRIO];
+
+/* NOTE: the hooks below are called by the scheduler with interrupts LOCKED */
+static inline void SST_stackDispatch_(uint8_t p) {
+    uint8_t *sp = SST_STACK_SP();
+    uint16_t depth;
+    if ((SST_stackNest_ == (uint8_t)0) && (sp > SST_stackBase_)) {
+        SST_stackBase_ = sp;                     /* a higher outer frame */
+    }
+    SST_stackChain_[SST_stackNest_++] = p;
+    if (SST_stackNest_ > SST_stackProf_.maxNest) {
+        SST_stackProf_.maxNest = SST_stackNest_;
+    }
+    if (sp > SST_stackBase_) {          /* above the base, nothing to say */
+        return;
+    }
+    depth = (uint16_t)(SST_stackBase_ - sp);
+    if (depth > SST_stackProf_.maxDepth[p - 1U]) {
+        SST_stackProf_.maxDepth[p - 1U] = depth;
+        if (depth > SST_stackProf_.peakDepth) {   /* a new peak, the chain */
+            uint8_t i;
+            SST_stackProf_.peakDepth = depth;
+            SST_stackProf_.peakLen = SST_stackNest_;
+            for (i = (uint8_t)0; i < SST_stackNest_; ++i) {
+                SST_stackProf_.peakChain[i] = SST_stackChain_[i];
+            }
+        }
+    }
+}
+static inline void SST_stackDone_(void) {
+    --SST_stackNest_;
+}
+
+#endif                                                    /* SST_STACK_PROF */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* sst_stack_h */
@@ -0,0 +1,136 @@
+/*****************************************************************************
+* SST runtime statistics
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: With SST_STATS defined the kernel keeps, for every task, the number
+  of dispatches, the CPU time used (total and the longest run to completion),
+  the highest queue occupancy, the failed posts and the preemptions it
+  suffered, and it keeps the idle and the ISR time. The CPU time is charged
+  at every dispatch, completion and ISR entry/exit to whatever ran since the
+  previous one, reading SST_CYCLES(), so it is exclusive: a task is not
+  charged for the tasks and ISRs that preempted it. A mutex ceiling does not
+  change which task is charged.
+  SST_getStats() copies the statistics without locking interrupts and
+  retries when the kernel updated them meanwhile (sequence count); after a
+  few failed tries it copies each task under a short lock, and then only the
+  counters of each task are consistent with each other.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#ifndef sst_stats_h
+#define sst_stats_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SST_STATS
+
+typedef struct SSTTaskStatsTag SSTTaskStats;
+struct SSTTaskStatsTag {
+    uint64_t runTime;                    /* CPU time, SST_CYCLES() units */
+    uint32_t maxRun;                  /* longest run to completion, ditto */
+    uint32_t curRun__;                         /* the run in progress */
+    uint32_t dispatches;
+    uint32_t preemptions;                 /* times preempted by a task */
+    uint16_t postFails;                    /* posts lost on a full queue */
+    uint8_t  maxUsed;                    /* queue high-water mark (nUsed) */
+    uint8_t  reserved__;
+};
+
+typedef struct SSTStatsTag SSTStats;
+struct SSTStatsTag {
+    uint64_t idleTime;                   /* CPU time of the idle loop */
+    uint64_t isrTime;                     /* CPU time of the ISRs */
+    uint32_t hz;                   /* SST_CYCLES_HZ, set by SST_getStats() */
+    uint8_t  consistent;       /* 0: only each task's counters consistent */
+    SSTTaskStats task[SST_MAX_PRIO];               /* task[prio - 1] */
+};
+
+uint8_t SST_getStats(SSTStats *st);
+void SST_statsReset(void);
+
+extern SSTStats SST_stats_;
+extern volatile uint32_t SST_statsSeq_;      /* changes with every update */
+extern uint32_t SST_statsLast_;         /* SST_CYCLES() of the last charge */
+extern uint8_t SST_statsRunning_;          /* charged task, 0 is idle */
+extern uint8_t SST_statsIsrNest_;
+
+/* NOTE: the hooks below are called by the kernel with interrupts LOCKED */
+static inline void SST_statsCharge_(void) {
+    uint32_t now = SST_CYCLES();
+    uint32_t dt = now - SST_statsLast_;
+    SST_statsLast_ = now;
+    if (SST_statsIsrNest_ != (uint8_t)0) {
+        SST_stats_.isrTime += dt;
+    }
+    else if (SST_statsRunning_ == (uint8_t)0) {
+        SST_stats_.idleTime += dt;
+    }
+    else {
+        SSTTaskStats *t = &SST_stats_.task[SST_statsRunning_ - 1U];
+        t->runTime += dt;
+        t->curRun__ += dt;
+    }
+}
+static inline uint8_t SST_statsDispatch_(uint8_t p) {
+    uint8_t prev = SST_statsRunning_;
+    ++SST_statsSeq_;
+    SST_statsCharge_();
+    if (prev != (uint8_t)0) {
+        ++SST_stats_.task[prev - 1U].preemptions;
+    }
+    ++SST_stats_.task[p - 1U].dispatches;
+    SST_stats_.task[p - 1U].curRun__ = 0U;
+    SST_statsRunning_ = p;
+    ++SST_statsSeq_;
+    return prev;                      /* restored by SST_statsDone_() */
+}
+static inline void SST_statsDone_(uint8_t p, uint8_t prev) {
+    SSTTaskStats *t = &SST_stats_.task[p - 1U];
+    ++SST_statsSeq_;
+    SST_statsCharge_();
+    if (t->curRun__ > t->maxRun) {
+        t->maxRun = t->curRun__;
+    }
+    SST_statsRunning_ = prev;
+    ++SST_statsSeq_;
+}
+static inline void SST_statsIsr_(int8_t nest) {
+    ++SST_statsSeq_;
+    SST_statsCharge_();
+    SST_statsIsrNest_ = (uint8_t)(SST_statsIsrNest_ + nest);
+    ++SST_statsSeq_;
+}
+static inline void SST_statsPost_(uint8_t p, uint8_t nUsed, uint8_t ok) {
+    SSTTaskStats *t = &SST_stats_.task[p - 1U];
+    ++SST_statsSeq_;
+    if (!ok) {
+        ++t->postFails;
+    }
+    else if (nUsed > t->maxUsed) {
+        t->maxUsed = nUsed;
+    }
+    ++SST_statsSeq_;
+}
+#define SST_STATS_ISR_(nest_)  SST_statsIsr_(nest_)
+
+#else                                                          /* SST_STATS */
+
+#define SST_STATS_ISR_(nest_)  ((void)0)
+
+#endif                                                         /* SST_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* sst_stats_h */
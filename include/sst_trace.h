@@ -0,0 +1,108 @@
+/*****************************************************************************
+* SST kernel trace
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: With SST_TRACE defined the kernel records its activity in a ring
+  buffer of SST_TRACE_LEN 8-byte records: a 32-bit timestamp from the port's
+  SST_CYCLES() (the CPU cycle counter on the ESP8266), the record type, the
+  priority running when it was taken, and two type-specific bytes. A record
+  is a handful of stores under the interrupt lock the kernel already holds,
+  and the oldest records are overwritten. Without SST_TRACE every record
+  compiles to nothing.
+  SST_traceDump() writes a header and the records, oldest first, through a
+  callback (e.g. to the UART); tools/sst_trace.py turns such a dump into a
+  Chrome trace / Perfetto JSON file.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+
+#ifndef sst_trace_h
+#define sst_trace_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum SSTTraceTypes {                   /* record types, a and b per record */
+    SST_TRC_POST = 1,                            /* a: target, b: signal */
+    SST_TRC_POST_FAIL,                 /* a: target, b: signal, queue full */
+    SST_TRC_DISPATCH,            /* a: task, b: signal, started from idle */
+    SST_TRC_PREEMPT,       /* a: task, b: signal, preempting the priority */
+    SST_TRC_DONE,                                  /* a: task, b: signal */
+    SST_TRC_ISR_ENTRY,                  /* a: ISR priority, b: interrupted */
+    SST_TRC_ISR_EXIT,                 /* a: ISR priority, b: restored prio */
+    SST_TRC_MUTEX_LOCK,                  /* a: ceiling, b: original prio */
+    SST_TRC_MUTEX_UNLOCK,                           /* a: restored prio */
+    SST_TRC_SEM_BLOCK,                      /* a: task, b: semaphore count */
+    SST_TRC_SEM_WAKE,                                          /* a: task */
+    SST_TRC_USER = 0x80                /* application records, 0x80..0xFF */
+};
+
+#ifdef SST_TRACE
+
+#ifndef SST_TRACE_LEN_LOG2
+#define SST_TRACE_LEN_LOG2 8                           /* 256 records, 2KB */
+#endif
+#define SST_TRACE_LEN (1U << SST_TRACE_LEN_LOG2)
+
+#ifndef SST_TRACE_TS                      /* timestamps, the cycle counter */
+#define SST_TRACE_TS()   SST_CYCLES()
+#define SST_TRACE_TS_HZ  SST_CYCLES_HZ
+#endif
+
+typedef struct SSTTraceRecTag SSTTraceRec;
+struct SSTTraceRecTag {
+    uint32_t ts;                          /* SST_TRACE_TS() when recorded */
+    uint8_t  type;                                    /* SSTTraceTypes */
+    uint8_t  prio;                          /* SST_currPrio_ when recorded */
+    uint8_t  a;
+    uint8_t  b;
+};
+
+typedef void (*SSTTraceOut)(void const *data, uint16_t len);
+
+extern SSTTraceRec SST_traceBuf_[SST_TRACE_LEN];
+extern uint16_t SST_traceHead_;                 /* free-running write index */
+extern uint8_t SST_traceOn_;
+extern uint8_t SST_traceFull_;     /* the ring was filled, all records valid */
+
+/* NOTE: SST_traceRec_() must be called with interrupts LOCKED */
+static inline void SST_traceRec_(uint8_t type, uint8_t a, uint8_t b) {
+    if (SST_traceOn_) {
+        uint16_t i = SST_traceHead_++;
+        SSTTraceRec *r = &SST_traceBuf_[i & (SST_TRACE_LEN - 1U)];
+        if (i == (uint16_t)(SST_TRACE_LEN - 1U)) {
+            SST_traceFull_ = (uint8_t)1;     /* stays set when head wraps */
+        }
+        r->ts   = SST_TRACE_TS();
+        r->type = type;
+        r->prio = SST_currPrio_;
+        r->a    = a;
+        r->b    = b;
+    }
+}
+#define SST_TRACE_REC(type_, a_, b_) \
+    SST_traceRec_((uint8_t)(type_), (uint8_t)(a_), (uint8_t)(b_))
+
+void SST_traceUser(uint8_t type, uint8_t a, uint8_t b);
+void SST_traceEnable(uint8_t on);
+void SST_traceDump(SSTTraceOut out);
+
+#else                                                          /* SST_TRACE */
+
+#define SST_TRACE_REC(type_, a_, b_)  ((void)0)
+
+#endif                                                         /* SST_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                       /* sst_trace_h */
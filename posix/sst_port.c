@@ -0,0 +1,318 @@
+/*****************************************************************************
+* SST port to POSIX hosts (Linux, macOS), GCC/Clang
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE                         /* pthread_setaffinity_np() */
+#endif
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include "sst_port.h"
+#if SST_MAX_KERNELS > 1
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/* Public-scope objects ----------------------------------------------------*/
+SST_KERNEL_TLS volatile uint8_t  SST_posixIntLocked_; /* software int. mask */
+SST_KERNEL_TLS volatile uint32_t SST_posixIrqPending_; /* latched irqs */
+
+/* Local-scope objects -----------------------------------------------------*/
+static SSTPosixIsr l_isr[SST_POSIX_IRQS];
+static int l_signo[SST_POSIX_IRQS];
+
+static uint64_t l_simNow;         /* simulated low-power timer, in counts */
+static uint64_t l_simTicks;            /* ticks accounted since the reset */
+static uint32_t l_simTickBase;    /* SST_tickCount() at the reset */
+static uint32_t l_simWakeups;
+static uint8_t  l_simCorrect;
+
+/*..........................................................................*/
+static void onSignal(int signo) {
+    int err = errno;                  /* the ISR must not clobber errno */
+    uint8_t irq;
+    for (irq = (uint8_t)0; irq < (uint8_t)SST_POSIX_IRQS; ++irq) {
+        if ((l_isr[irq] != (SSTPosixIsr)0) && (l_signo[irq] == signo)) {
+            break;
+        }
+    }
+    if (irq < (uint8_t)SST_POSIX_IRQS) {
+        if (SST_posixIntLocked_) {           /* interrupts locked, latch it */
+            __atomic_fetch_or(&SST_posixIrqPending_, (uint32_t)1 << irq,
+                              __ATOMIC_SEQ_CST);
+        }
+        else {
+            SST_posixIntLocked_ = 1;   /* the CPU locks interrupts on entry */
+            (*l_isr[irq])();
+            SST_posixIntLocked_ = 0;     /* ...and unlocks them on return */
+            if (SST_posixIrqPending_ != 0U) {
+                SST_posixIrqReplay_();
+            }
+        }
+    }
+    errno = err;
+}
+/*..........................................................................*/
+/* NOTE: SST_posixIrqReplay_() runs the ISRs latched while interrupts were
+ * locked, highest irq number first, as if they had just been delivered.
+ */
+void SST_posixIrqReplay_(void) {
+    do {
+        uint32_t pend;
+        SST_posixIntLocked_ = 1;
+        pend = __atomic_exchange_n(&SST_posixIrqPending_, (uint32_t)0,
+                                   __ATOMIC_SEQ_CST);
+        while (pend != 0U) {
+            uint8_t irq = (uint8_t)(SST_log2_32(pend) - 1U);
+            pend &= ~((uint32_t)1 << irq);
+            SST_posixIntLocked_ = 1;
+            (*l_isr[irq])();             /* the ISR exits with ints locked */
+        }
+        SST_posixIntLocked_ = 0;
+    } while (SST_posixIrqPending_ != 0U);  /* arrived after the exchange? */
+}
+/*..........................................................................*/
+void SST_posixIrqAttach(uint8_t irq, int signo, SSTPosixIsr isr) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = &onSignal;
+    sigemptyset(&sa.sa_mask);       /* other irqs may preempt this one... */
+    sa.sa_flags = SA_NODEFER | SA_RESTART;     /* ...and so may this one */
+    l_signo[irq] = signo;
+    l_isr[irq] = isr;
+    sigaction(signo, &sa, (struct sigaction *)0);
+}
+/*..........................................................................*/
+void SST_posixIrqRaise(uint8_t irq) {
+    raise(l_signo[irq]);         /* delivered before raise() returns */
+}
+/*..........................................................................*/
+void SST_posixTimerStart(uint32_t usec) {
+    struct itimerval it;
+    it.it_interval.tv_sec  = (time_t)(usec / 1000000U);
+    it.it_interval.tv_usec = (suseconds_t)(usec % 1000000U);
+    it.it_value = it.it_interval;
+    setitimer(ITIMER_REAL, &it, (struct itimerval *)0);
+}
+/*..........................................................................*/
+void SST_posixTimerStop(void) {
+    struct itimerval it;
+    memset(&it, 0, sizeof(it));
+    setitimer(ITIMER_REAL, &it, (struct itimerval *)0);
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: The simulated clock models a target that sleeps on a low-power timer
+  of SST_POSIX_LP_HZ while the kernel counts ticks of SST_POSIX_TICK_HZ. The
+  rates are not multiples of each other, so converting a sleep of n ticks to
+  timer counts rounds. Without the correction every sleep truncates and the
+  kernel time runs ahead of the real time. With the correction the port
+  wakes at the timer count of the tick boundary, computed from the total
+  ticks, and announces only the ticks that really elapsed, so the rounding
+  never accumulates.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static uint64_t tickToLp(uint64_t ticks) {            /* rounded up */
+    return (ticks * SST_POSIX_LP_HZ + (SST_POSIX_TICK_HZ - 1U))
+           / SST_POSIX_TICK_HZ;
+}
+/*..........................................................................*/
+void SST_posixSimReset(uint8_t correct) {
+    l_simNow = 0U;
+    l_simTicks = 0U;
+    l_simTickBase = SST_tickCount();
+    l_simWakeups = 0U;
+    l_simCorrect = correct;
+}
+/*..........................................................................*/
+void SST_posixSimTick(void) {
+    ++l_simTicks;
+    l_simNow = tickToLp(l_simTicks);
+    ++l_simWakeups;
+    SST_tick();
+}
+/*..........................................................................*/
+/* NOTE: SST_onSleep() is entered with interrupts locked and returns with
+ * them unlocked, like a wait-for-interrupt instruction. With nothing armed
+ * (ticks == 0) a target would sleep until an external interrupt; there are
+ * none in the simulation, so it returns at once.
+ */
+uint16_t SST_onSleep(uint16_t ticks) {
+    uint16_t elapsed = (uint16_t)0;
+    if (ticks != (uint16_t)0) {
+        if (l_simCorrect) {
+            l_simNow = tickToLp(l_simTicks + ticks);
+            elapsed = (uint16_t)(l_simNow * SST_POSIX_TICK_HZ
+                                 / SST_POSIX_LP_HZ - l_simTicks);
+        }
+        else {
+            l_simNow += (uint64_t)ticks * SST_POSIX_LP_HZ
+                        / SST_POSIX_TICK_HZ;                  /* truncates */
+            elapsed = ticks;
+        }
+        l_simTicks += elapsed;
+        ++l_simWakeups;
+    }
+    SST_INT_UNLOCK();
+    return elapsed;
+}
+/*..........................................................................*/
+uint64_t SST_posixSimNow(void) {
+    return l_simNow;
+}
+/*..........................................................................*/
+uint32_t SST_posixSimWakeups(void) {
+    return l_simWakeups;
+}
+/*..........................................................................*/
+int32_t SST_posixSimDriftUs(void) {
+    int64_t kernelUs = (int64_t)(uint32_t)(SST_tickCount() - l_simTickBase)
+                       * 1000000 / SST_POSIX_TICK_HZ;
+    int64_t realUs = (int64_t)(l_simNow * 1000000U / SST_POSIX_LP_HZ);
+    return (int32_t)(kernelUs - realUs);
+}
+#if defined(__i386__) || defined(__x86_64__)
+/*..........................................................................*/
+/* NOTE: SST_posixTscHz() measures the TSC rate against the host clock over
+ * 20ms, once, to convert the SST_CYCLES() timestamps.
+ */
+uint32_t SST_posixTscHz(void) {
+    static uint32_t hz;
+    if (hz == 0U) {
+        struct timespec t0;
+        struct timespec t1;
+        struct timespec d = { 0, 20000000 };
+        uint32_t c0;
+        uint32_t c1;
+        uint64_t ns;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        c0 = SST_cycles_();
+        nanosleep(&d, (struct timespec *)0);
+        c1 = SST_cycles_();
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000U
+             + (uint64_t)t1.tv_nsec - (uint64_t)t0.tv_nsec;
+        hz = (uint32_t)((uint64_t)(uint32_t)(c1 - c0) * 1000000000U / ns);
+    }
+    return hz;
+}
+#endif
+#if SST_MAX_KERNELS > 1
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: SST_posixCoreStart() runs the kernel 'k' on a thread of its own,
+  pinned to the CPU 'cpu' unless it is negative, which stands for one core
+  of a partitioned target. The thread binds the kernel, lets 'init' create
+  its tasks and inbox, and then loops draining the inbox. It sleeps on a
+  condition variable when the inbox is empty; a poster wakes it from
+  SST_onInbox() only when it announced that it is going to sleep, so a
+  busy kernel costs its posters one load. Both sides store their flag and
+  then read the other's, each behind a full fence, so a post cannot slip
+  in between the kernel's last check and its sleep.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+typedef struct CoreTag Core;
+struct CoreTag {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    SSTKernel *k;
+    SSTPosixCoreInit init;
+    int cpu;
+    uint8_t sleeping;                     /* the kernel waits on 'wake' */
+    uint8_t stop;
+} __attribute__((aligned(64)));
+
+static Core l_core[SST_MAX_KERNELS];
+
+/*..........................................................................*/
+static void *coreMain(void *arg) {
+    Core *c = (Core *)arg;
+#ifdef __linux__
+    if (c->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(c->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+    SST_kernelBind(c->k);
+    (*c->init)();
+    SST_INT_LOCK();
+    SST_currPrio_ = (uint8_t)0;            /* the idle loop of this kernel */
+    SST_schedule_();
+    SST_INT_UNLOCK();
+    for (;;) {
+        if (SST_inboxDrain() != (uint16_t)0) {
+            continue;
+        }
+        __atomic_store_n(&c->sleeping, (uint8_t)1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (SST_inboxPending(c->k)) {
+            __atomic_store_n(&c->sleeping, (uint8_t)0, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_load_n(&c->stop, __ATOMIC_ACQUIRE)) {
+            break;                                   /* stopped and empty */
+        }
+        pthread_mutex_lock(&c->lock);
+        while (__atomic_load_n(&c->sleeping, __ATOMIC_ACQUIRE)
+               && !__atomic_load_n(&c->stop, __ATOMIC_ACQUIRE))
+        {
+            pthread_cond_wait(&c->wake, &c->lock);
+        }
+        pthread_mutex_unlock(&c->lock);
+        __atomic_store_n(&c->sleeping, (uint8_t)0, __ATOMIC_RELAXED);
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void wakeCore(Core *c) {
+    pthread_mutex_lock(&c->lock);
+    pthread_cond_signal(&c->wake);
+    pthread_mutex_unlock(&c->lock);
+}
+/*..........................................................................*/
+void SST_onInbox(SSTKernel *k) {
+    Core *c = &l_core[k->id__];
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&c->sleeping, __ATOMIC_RELAXED)
+        && __atomic_exchange_n(&c->sleeping, (uint8_t)0, __ATOMIC_ACQ_REL))
+    {
+        wakeCore(c);
+    }
+}
+/*..........................................................................*/
+void SST_posixCoreStart(SSTKernel *k, SSTPosixCoreInit init, int cpu) {
+    Core *c = &l_core[k->id__];
+    pthread_mutex_init(&c->lock, (pthread_mutexattr_t *)0);
+    pthread_cond_init(&c->wake, (pthread_condattr_t *)0);
+    c->k = k;
+    c->init = init;
+    c->cpu = cpu;
+    c->sleeping = (uint8_t)0;
+    c->stop = (uint8_t)0;
+    pthread_create(&c->thread, (pthread_attr_t *)0, &coreMain, c);
+}
+/*..........................................................................*/
+/* NOTE: SST_posixCoreStop() returns once the kernel 'k' has run all the
+ * events of its inbox and its thread has ended. The other kernels must
+ * have stopped posting to it.
+ */
+void SST_posixCoreStop(SSTKernel *k) {
+    Core *c = &l_core[k->id__];
+    __atomic_store_n(&c->stop, (uint8_t)1, __ATOMIC_RELEASE);
+    wakeCore(c);
+    pthread_join(c->thread, (void **)0);
+    pthread_cond_destroy(&c->wake);
+    pthread_mutex_destroy(&c->lock);
+}
+#endif                                             /* SST_MAX_KERNELS > 1 */
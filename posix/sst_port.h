@@ -0,0 +1,140 @@
+/*****************************************************************************
+* SST port to POSIX hosts (Linux, macOS), GCC/Clang
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: On the host the "interrupts" are POSIX signals. Each interrupt line
+  (irq) is bound to a signal with SST_posixIrqAttach(), and its ISR runs in
+  the signal handler with the usual SST_ISR_ENTRY()/SST_ISR_EXIT() pattern,
+  so tasks preempted by an ISR run nested on the same stack exactly like on
+  the target.
+  SST_INT_LOCK()/SST_INT_UNLOCK() mask interrupts in software: a signal that
+  arrives while the lock is held is latched as pending and its ISR is
+  replayed by SST_INT_UNLOCK(). This costs two stores instead of two
+  sigprocmask() system calls, so the benchmarks measure the kernel and not
+  the host OS. Like on the ESP8266 the lock does not nest.
+  With SST_MAX_KERNELS above 1 every kernel runs on a host thread of its
+  own, optionally pinned to a CPU, with its own interrupt mask; the irq
+  signals should then be blocked in all threads but the one of the kernel
+  that owns the ISRs.
+  Put this directory before include/ on the include path.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef sst_port_h
+#define sst_port_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+                                         /* SST interrupt locking/unlocking */
+#define SST_INT_LOCK()   do { \
+    SST_posixIntLocked_ = 1; \
+    __asm__ __volatile__ ("" ::: "memory"); \
+} while (0)
+#define SST_INT_UNLOCK() do { \
+    __asm__ __volatile__ ("" ::: "memory"); \
+    SST_posixIntLocked_ = 0; \
+    __asm__ __volatile__ ("" ::: "memory"); \
+    if (SST_posixIrqPending_ != 0U) { \
+        SST_posixIrqReplay_(); \
+    } \
+} while (0)
+                                               /* maximum SST task priority */
+#ifndef SST_MAX_PRIO
+#define SST_MAX_PRIO     32
+#endif
+                    /* kernels, one per host thread, see SST_posixCoreStart() */
+#ifndef SST_MAX_KERNELS
+#define SST_MAX_KERNELS  1
+#endif
+#if SST_MAX_KERNELS > 1
+#define SST_KERNEL_TLS   __thread   /* and a software interrupt mask each */
+#else
+#define SST_KERNEL_TLS
+#endif
+
+#define os_printf        printf            /* SDK services used by the kernel */
+#define os_memcpy        memcpy
+
+                /* SSTRing fences, the stress test uses two host threads */
+#define SST_MEM_BARRIER()      __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#define SST_MEM_FULL_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+                  /* cycle counter for the kernel trace and statistics */
+#if defined(__i386__) || defined(__x86_64__)
+static inline uint32_t SST_cycles_(void) {         /* TSC, a few cycles */
+    uint32_t lo;
+    uint32_t hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    (void)hi;
+    return lo;
+}
+#define SST_CYCLES_HZ    SST_posixTscHz()       /* calibrated on first use */
+uint32_t SST_posixTscHz(void);
+#else
+static inline uint32_t SST_cycles_(void) {          /* host clock in ns */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U
+                      + (uint64_t)ts.tv_nsec);
+}
+#define SST_CYCLES_HZ    1000000000U
+#endif
+#define SST_CYCLES()     SST_cycles_()
+
+#define SST_POSIX_IRQS   8                 /* number of host interrupt lines */
+
+                /* tickless idle on a simulated low-power clock (sst_tev.c) */
+#define SST_TICKLESS
+#ifndef SST_POSIX_TICK_HZ
+#define SST_POSIX_TICK_HZ 1000U               /* kernel tick rate [Hz] */
+#endif
+#ifndef SST_POSIX_LP_HZ
+#define SST_POSIX_LP_HZ   32768U     /* simulated low-power timer rate [Hz] */
+#endif
+
+typedef void (*SSTPosixIsr)(void);
+
+void SST_posixIrqAttach(uint8_t irq, int signo, SSTPosixIsr isr);
+void SST_posixIrqRaise(uint8_t irq);          /* synchronous, from a task */
+void SST_posixTimerStart(uint32_t usec);          /* periodic SIGALRM */
+void SST_posixTimerStop(void);
+void SST_posixIrqReplay_(void);
+
+void SST_posixSimReset(uint8_t correct);       /* 0: no drift correction */
+void SST_posixSimTick(void);             /* one periodic tick, SST_tick() */
+uint64_t SST_posixSimNow(void);         /* simulated time in timer counts */
+uint32_t SST_posixSimWakeups(void);
+int32_t SST_posixSimDriftUs(void);       /* kernel time minus real time */
+
+extern SST_KERNEL_TLS volatile uint8_t  SST_posixIntLocked_;
+extern SST_KERNEL_TLS volatile uint32_t SST_posixIrqPending_;
+
+#include "sst.h"                      /* SST platform-independent interface */
+
+#if SST_MAX_KERNELS > 1
+typedef void (*SSTPosixCoreInit)(void);
+
+void SST_posixCoreStart(SSTKernel *k, SSTPosixCoreInit init, int cpu);
+void SST_posixCoreStop(SSTKernel *k);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* sst_port_h */
@@ -0,0 +1,563 @@
+/*****************************************************************************
+* SST port to a virtual-time simulator on POSIX hosts, GCC/Clang
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+
+#define REL_LEN    512U     /* releases per task, a queue plus a full pool */
+#define STACK_LEN  (SST_MAX_PRIO + SST_SIM_IRQS + 2)
+#define OWNER_IRQ  0x100U        /* stack entries: prio, or OWNER_IRQ + irq */
+#define NO_IRQ     0xFFU
+
+typedef struct {                          /* an arrival, or a periodic one */
+    uint64_t at;
+    uint64_t base;                             /* 'at' without the jitter */
+    uint64_t period;                                     /* 0: just once */
+    uint64_t jitter;
+    uint32_t seq;                            /* FIFO among equal 'at' */
+    uint8_t  irq;
+    uint8_t  par;
+} Arrival;
+
+typedef struct {
+    SSTSimIsr isr;
+    uint64_t latched;                         /* arrival of the latched one */
+    uint32_t cost;
+    uint8_t  prio;
+    uint8_t  par;
+    SSTSimIrqStats st;
+} Irq;
+
+typedef struct {
+    uint64_t rel[REL_LEN];       /* post times of the queued events, FIFO */
+    uint64_t cur;                      /* post time of the event running */
+    uint64_t since;                        /* queue area accounted until */
+    uint16_t head;
+    uint16_t n;
+    uint8_t  blocked;            /* blocked on a semaphore in this run */
+    uint8_t  open;     /* the event continues in the run after a wakeup */
+    uint8_t  wakes;                        /* wakeups the kernel counts */
+    SSTSimTaskStats st;
+} Task;
+
+/* Public-scope objects ----------------------------------------------------*/
+uint64_t SST_simNow_;                                   /* the virtual clock */
+volatile uint8_t  SST_simIntLocked_;               /* software int. mask */
+volatile uint32_t SST_simIrqPending_;                  /* latched irqs */
+
+/* Local-scope objects -----------------------------------------------------*/
+static Irq l_irq[SST_SIM_IRQS];
+static Task l_task[SST_MAX_PRIO];
+static Arrival *l_heap;                   /* min-heap on (at, seq) */
+static uint32_t l_heapLen;
+static uint32_t l_heapCap;
+static uint32_t l_seq;
+static uint32_t l_seed = 0x2545F491U;
+static uint16_t l_stack[STACK_LEN];       /* what runs, from the trace */
+static uint8_t  l_depth;
+static uint16_t l_traceSeen;
+static uint32_t l_traceLost;
+static uint8_t  l_replPrio;      /* a POST now replaces the lost event */
+static uint8_t  l_curIrq = (uint8_t)NO_IRQ;
+static uint8_t  l_curPar;
+static uint8_t  l_started;
+
+/*..........................................................................*/
+static uint8_t before_(Arrival const *a, Arrival const *b) {
+    return (uint8_t)((a->at < b->at) || ((a->at == b->at) && (a->seq < b->seq)));
+}
+static uint8_t push_(Arrival *a) {
+    uint32_t i;
+    if (l_heapLen == l_heapCap) {
+        uint32_t cap = (l_heapCap == 0U) ? 64U : 2U * l_heapCap;
+        Arrival *h = (Arrival *)realloc(l_heap, cap * sizeof(Arrival));
+        if (h == (Arrival *)0) {
+            return (uint8_t)0;
+        }
+        l_heap = h;
+        l_heapCap = cap;
+    }
+    a->seq = l_seq++;
+    for (i = l_heapLen++; i != 0U; i = (i - 1U) / 2U) {     /* sift up */
+        if (!before_(a, &l_heap[(i - 1U) / 2U])) {
+            break;
+        }
+        l_heap[i] = l_heap[(i - 1U) / 2U];
+    }
+    l_heap[i] = *a;
+    return (uint8_t)1;
+}
+static void pop_(Arrival *a) {
+    Arrival last = l_heap[--l_heapLen];
+    uint32_t i = 0U;
+    *a = l_heap[0];
+    for (;;) {                                              /* sift down */
+        uint32_t c = 2U * i + 1U;
+        if (c >= l_heapLen) {
+            break;
+        }
+        if ((c + 1U < l_heapLen) && before_(&l_heap[c + 1U], &l_heap[c])) {
+            ++c;
+        }
+        if (!before_(&l_heap[c], &last)) {
+            break;
+        }
+        l_heap[i] = l_heap[c];
+        i = c;
+    }
+    if (l_heapLen != 0U) {
+        l_heap[i] = last;
+    }
+}
+static uint32_t rand_(void) {                               /* xorshift32 */
+    l_seed ^= l_seed << 13;
+    l_seed ^= l_seed >> 17;
+    l_seed ^= l_seed << 5;
+    return l_seed;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: The virtual clock stands still between two calls of spend_(), so
+  all the trace records taken since the last scan are of SST_simNow_ and
+  their 32-bit timestamps are not needed. Every queued event of a task has
+  its post time in the task's FIFO; a dispatch takes the oldest and the
+  completion charges the response time, unless the task blocked on a
+  semaphore, when the event stays open until the run after the wakeup. A
+  post that replaces a queued event under an overflow policy keeps the
+  release time of the event it replaced, and an urgent post is matched in
+  the order of the posts.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+static void queueArea_(Task *t) {
+    t->st.queueArea += (uint64_t)t->n * (SST_simNow_ - t->since);
+    t->since = SST_simNow_;
+}
+static Task *task_(uint8_t prio) {            /* 0 for the idle and ISRs */
+    #if SST_MAX_PRIO < 0xFF
+    if (prio > (uint8_t)SST_MAX_PRIO) {
+        return (Task *)0;
+    }
+    #endif
+    return (prio != (uint8_t)0) ? &l_task[prio - 1U] : (Task *)0;
+}
+static void onRec_(SSTTraceRec const *r) {
+    Task *t = task_(r->a);
+    uint8_t repl = l_replPrio;
+    l_replPrio = (uint8_t)0;
+    switch (r->type) {
+        case SST_TRC_POST:
+            if ((t != (Task *)0) && (repl != r->a) && (t->n < REL_LEN)) {
+                queueArea_(t);
+                t->rel[(t->head + t->n) & (REL_LEN - 1U)] = SST_simNow_;
+                if (++t->n > t->st.queueMax) {
+                    t->st.queueMax = t->n;
+                }
+            }
+            break;
+        case SST_TRC_POST_FAIL:
+            if (t != (Task *)0) {
+                ++t->st.drops;
+                l_replPrio = r->a;
+            }
+            break;
+        case SST_TRC_DISPATCH:
+        case SST_TRC_PREEMPT:
+            if (l_depth < (uint8_t)STACK_LEN) {
+                l_stack[l_depth++] = r->a;
+            }
+            if (t == (Task *)0) {
+                break;
+            }
+            if (t->wakes != 0U) {     /* the kernel runs wakeups first */
+                --t->wakes;
+                if (t->open) {
+                    t->open = (uint8_t)0;
+                    break;                   /* the same event continues */
+                }
+            }
+            else if (t->n != 0U) {
+                queueArea_(t);
+                t->open = (uint8_t)0;
+                t->cur = t->rel[t->head];
+                t->head = (uint16_t)((t->head + 1U) & (REL_LEN - 1U));
+                --t->n;
+                break;
+            }
+            t->open = (uint8_t)0;
+            t->cur = SST_simNow_;
+            break;
+        case SST_TRC_DONE:
+            if (l_depth != 0U) {
+                --l_depth;
+            }
+            if (t == (Task *)0) {
+                break;
+            }
+            if (t->blocked) {
+                t->blocked = (uint8_t)0;
+                t->open = (uint8_t)1;
+            }
+            else {
+                uint64_t resp = SST_simNow_ - t->cur;
+                ++t->st.events;
+                t->st.respSum += resp;
+                if (resp > t->st.respMax) {
+                    t->st.respMax = resp;
+                }
+            }
+            break;
+        case SST_TRC_SEM_BLOCK:
+            if (t != (Task *)0) {
+                t->blocked = (uint8_t)1;
+            }
+            break;
+        case SST_TRC_SEM_WAKE:
+            if (t != (Task *)0) {
+                ++t->wakes;
+            }
+            break;
+        case SST_TRC_ISR_ENTRY:
+            if (l_depth < (uint8_t)STACK_LEN) {
+                l_stack[l_depth++] = (uint16_t)(OWNER_IRQ + l_curIrq);
+            }
+            break;
+        case SST_TRC_ISR_EXIT:
+            if (l_depth != 0U) {
+                --l_depth;
+            }
+            break;
+        default:
+            break;
+    }
+}
+static void scan_(void) {
+    uint16_t head = SST_traceHead_;
+    if ((uint16_t)(head - l_traceSeen) > (uint16_t)SST_TRACE_LEN) {
+        l_traceLost += (uint16_t)(head - l_traceSeen) - SST_TRACE_LEN;
+        l_traceSeen = (uint16_t)(head - SST_TRACE_LEN);
+    }
+    while (l_traceSeen != head) {
+        onRec_(&SST_traceBuf_[l_traceSeen++ & (SST_TRACE_LEN - 1U)]);
+    }
+}
+/*..........................................................................*/
+static void latch_(Arrival *a) {
+    Irq *q = &l_irq[a->irq];
+    uint32_t bit = (uint32_t)1 << a->irq;
+    ++q->st.arrivals;
+    if (a->period != 0U) {                          /* schedule the next one */
+        a->base += a->period;
+        a->at = a->base;
+        if (a->jitter != 0U) {
+            a->at += (uint64_t)rand_() % (a->jitter + 1U);
+        }
+        (void)push_(a);
+    }
+    if (q->isr == (SSTSimIsr)0) {
+        return;
+    }
+    if ((SST_simIrqPending_ & bit) != 0U) {
+        ++q->st.overruns;
+        return;
+    }
+    q->latched = SST_simNow_;
+    q->par = a->par;
+    SST_simIrqPending_ |= bit;
+}
+/*..........................................................................*/
+static void charge_(uint16_t owner, uint64_t dt) {
+    if (owner >= OWNER_IRQ) {
+        if ((uint16_t)(owner - OWNER_IRQ) < (uint16_t)SST_SIM_IRQS) {
+            l_irq[owner - OWNER_IRQ].st.busy += dt;
+        }
+    }
+    else if ((owner != 0U) && (owner <= SST_MAX_PRIO)) {
+        l_task[owner - 1U].st.busy += dt;
+    }
+}
+/*..........................................................................*/
+/* NOTE: spend_() lets 'cycles' pass for the 'owner'. The arrivals on the
+ * way are latched at their cycle and, with interrupts unlocked, their ISRs
+ * preempt the owner, which then goes on for what remains.
+ */
+static void spend_(uint64_t cycles, uint16_t owner) {
+    uint64_t left = cycles;
+    for (;;) {
+        Arrival a;
+        uint64_t due;
+        scan_();
+        due = (l_heapLen == 0U) ? (left + 1U)
+              : (l_heap[0].at > SST_simNow_) ? (l_heap[0].at - SST_simNow_)
+              : 0U;
+        if (due > left) {
+            charge_(owner, left);
+            SST_simNow_ += left;
+            return;
+        }
+        charge_(owner, due);
+        SST_simNow_ += due;
+        left -= due;
+        pop_(&a);
+        latch_(&a);
+        if (!SST_simIntLocked_ && (SST_simIrqPending_ != 0U)) {
+            SST_simIrqReplay_();
+        }
+    }
+}
+/*..........................................................................*/
+/* NOTE: SST_simIrqReplay_() runs the latched ISRs of a priority above
+ * SST_currPrio_, highest first and the lower irq on a tie. Like the CPU it
+ * locks interrupts for the ISR's entry cost and the call; the ISR exits
+ * with them locked.
+ */
+void SST_simIrqReplay_(void) {
+    for (;;) {
+        uint8_t best = SST_currPrio_;
+        uint8_t irq = (uint8_t)NO_IRQ;
+        uint8_t prevIrq = l_curIrq;
+        uint8_t prevPar = l_curPar;
+        uint64_t lat;
+        uint8_t i;
+        Irq *q;
+        for (i = (uint8_t)0; i < (uint8_t)SST_SIM_IRQS; ++i) {
+            if (((SST_simIrqPending_ & ((uint32_t)1 << i)) != 0U)
+                && (l_irq[i].prio > best)) {
+                best = l_irq[i].prio;
+                irq = i;
+            }
+        }
+        if (irq == (uint8_t)NO_IRQ) {
+            return;
+        }
+        q = &l_irq[irq];
+        SST_simIrqPending_ &= ~((uint32_t)1 << irq);
+        lat = SST_simNow_ - q->latched;
+        ++q->st.runs;
+        q->st.latencySum += lat;
+        if (lat > q->st.latencyMax) {
+            q->st.latencyMax = lat;
+        }
+        l_curIrq = irq;
+        l_curPar = q->par;
+        SST_simIntLocked_ = 1;
+        spend_(q->cost, (uint16_t)(OWNER_IRQ + irq));
+        (*q->isr)();                     /* the ISR exits with ints locked */
+        l_curIrq = prevIrq;
+        l_curPar = prevPar;
+        SST_simIntLocked_ = 0;
+    }
+}
+/*..........................................................................*/
+void SST_simIrqAttach(uint8_t irq, uint8_t isrPrio, SSTSimIsr isr,
+                      uint32_t cost)
+{
+    l_irq[irq].isr = isr;
+    l_irq[irq].prio = isrPrio;
+    l_irq[irq].cost = cost;
+}
+/*..........................................................................*/
+uint8_t SST_simArrive(uint64_t at, uint8_t irq, uint8_t par) {
+    Arrival a;
+    if (irq >= (uint8_t)SST_SIM_IRQS) {
+        return (uint8_t)0;
+    }
+    memset(&a, 0, sizeof(a));
+    a.at = at;
+    a.base = at;
+    a.irq = irq;
+    a.par = par;
+    return push_(&a);
+}
+/*..........................................................................*/
+/* NOTE: SST_simPeriodic() makes the irq arrive every 'period' cycles from
+ * 'phase' on, each arrival late by a uniform 0..'jitter' cycles.
+ */
+uint8_t SST_simPeriodic(uint8_t irq, uint8_t par, uint64_t phase,
+                        uint64_t period, uint64_t jitter)
+{
+    Arrival a;
+    if ((irq >= (uint8_t)SST_SIM_IRQS) || (period == 0U)) {
+        return (uint8_t)0;
+    }
+    memset(&a, 0, sizeof(a));
+    a.base = phase;
+    a.at = phase + ((jitter != 0U) ? (uint64_t)rand_() % (jitter + 1U) : 0U);
+    a.period = period;
+    a.jitter = jitter;
+    a.irq = irq;
+    a.par = par;
+    return push_(&a);
+}
+/*..........................................................................*/
+/* NOTE: SST_simLoad() reads a recorded trace, one arrival per line:
+ *   <time in microseconds> <irq> [<par>]
+ * Empty lines and lines starting with '#' are skipped. Returns the number
+ * of arrivals, or -1 when the file cannot be read or a line is malformed.
+ */
+int32_t SST_simLoad(char const *path) {
+    char line[128];
+    int32_t n = 0;
+    FILE *f = fopen(path, "r");
+    if (f == (FILE *)0) {
+        return -1;
+    }
+    while (fgets(line, (int)sizeof(line), f) != (char *)0) {
+        char *p = line;
+        char *end;
+        double us;
+        unsigned long irq;
+        unsigned long par = 0UL;
+        while ((*p == ' ') || (*p == '\t')) {
+            ++p;
+        }
+        if ((*p == '#') || (*p == '\n') || (*p == '\r') || (*p == '\0')) {
+            continue;
+        }
+        us = strtod(p, &end);
+        if ((end == p) || (us < 0.0)) {          /* no time, or a bad one */
+            n = -1;
+            break;
+        }
+        irq = strtoul(end, &p, 0);
+        if ((p == end) || (irq >= SST_SIM_IRQS)) {
+            n = -1;
+            break;
+        }
+        par = strtoul(p, &end, 0);
+        while ((*end == ' ') || (*end == '\t')) {
+            ++end;
+        }
+        if ((*end != '\n') && (*end != '\r') && (*end != '\0')) {
+            n = -1;                            /* a bad par, or trailing junk */
+            break;
+        }
+        if (!SST_simArrive((uint64_t)(us * (double)SST_SIM_HZ / 1e6 + 0.5),
+                           (uint8_t)irq, (uint8_t)par)) {
+            n = -1;
+            break;
+        }
+        ++n;
+    }
+    fclose(f);
+    return n;
+}
+/*..........................................................................*/
+void SST_simSeed(uint32_t seed) {
+    l_seed = (seed != 0U) ? seed : 0x2545F491U;
+}
+/*..........................................................................*/
+/* NOTE: SST_simCost() is the execution time of the code that calls it, a
+ * task or an ISR; with interrupts locked it is a critical section and the
+ * arrivals wait for SST_INT_UNLOCK().
+ */
+void SST_simCost(uint32_t cycles) {
+    scan_();
+    spend_(cycles, (l_depth != 0U) ? l_stack[l_depth - 1U] : (uint16_t)0);
+}
+/*..........................................................................*/
+/* NOTE: SST_simRun() is the idle loop. The first call runs SST_run(), so
+ * the tasks created before it process their events, and every call then
+ * jumps the clock from arrival to arrival up to 'until'. The arrivals
+ * before SST_run() stay latched until it, and the run to completion in
+ * progress at 'until' finishes.
+ */
+void SST_simRun(uint64_t until) {
+    if (!l_started) {
+        l_started = (uint8_t)1;
+        SST_run();
+    }
+    for (;;) {
+        Arrival a;
+        scan_();
+        if ((l_heapLen == 0U) || (l_heap[0].at > until)) {
+            break;
+        }
+        if (l_heap[0].at > SST_simNow_) {
+            SST_simNow_ = l_heap[0].at;
+        }
+        pop_(&a);
+        latch_(&a);
+        if (!SST_simIntLocked_ && (SST_simIrqPending_ != 0U)) {
+            SST_simIrqReplay_();
+        }
+    }
+    if (until > SST_simNow_) {
+        SST_simNow_ = until;
+    }
+}
+/*..........................................................................*/
+uint64_t SST_simNow(void) {
+    return SST_simNow_;
+}
+/*..........................................................................*/
+uint8_t SST_simIrqPar(void) {
+    return l_curPar;
+}
+/*..........................................................................*/
+SSTSimTaskStats const *SST_simTaskStats(uint8_t prio) {
+    Task *t = &l_task[prio - 1U];
+    scan_();
+    queueArea_(t);
+    return &t->st;
+}
+/*..........................................................................*/
+SSTSimIrqStats const *SST_simIrqStats(uint8_t irq) {
+    return &l_irq[irq].st;
+}
+/*..........................................................................*/
+uint32_t SST_simTraceLost(void) {
+    return l_traceLost;
+}
+/*..........................................................................*/
+static double us_(uint64_t cycles) {
+    return (double)cycles * 1e6 / (double)SST_SIM_HZ;
+}
+/*..........................................................................*/
+/* NOTE: SST_simReport() lists the tasks and the irqs that saw any activity;
+ * the times are in microseconds and the load in percent of the run.
+ */
+void SST_simReport(FILE *out) {
+    double total = (SST_simNow_ != 0U) ? (double)SST_simNow_ : 1.0;
+    uint16_t p;
+    uint8_t i;
+    fprintf(out, "simulated %.6f s (%llu cycles at %u Hz)\n",
+            (double)SST_simNow_ / (double)SST_SIM_HZ,
+            (unsigned long long)SST_simNow_, (unsigned)SST_SIM_HZ);
+    fprintf(out, "%4s %9s %6s %11s %11s %6s %8s %7s\n", "prio", "events",
+            "load%", "resp avg", "resp max", "q max", "q avg", "drops");
+    for (p = 1U; p <= (uint16_t)((SST_MAX_PRIO < 0xFF) ? SST_MAX_PRIO : 0xFF);
+         ++p) {
+        SSTSimTaskStats const *s = SST_simTaskStats((uint8_t)p);
+        if ((s->events == 0U) && (s->drops == 0U) && (s->queueMax == 0U)) {
+            continue;
+        }
+        fprintf(out, "%4u %9u %6.2f %11.1f %11.1f %6u %8.3f %7u\n",
+                (unsigned)p, (unsigned)s->events,
+                100.0 * (double)s->busy / total,
+                (s->events != 0U) ? us_(s->respSum) / s->events : 0.0,
+                us_(s->respMax), (unsigned)s->queueMax,
+                (double)s->queueArea / total, (unsigned)s->drops);
+    }
+    fprintf(out, "%4s %9s %6s %11s %11s %8s\n", "irq", "arrivals", "load%",
+            "lat avg", "lat max", "overruns");
+    for (i = (uint8_t)0; i < (uint8_t)SST_SIM_IRQS; ++i) {
+        SSTSimIrqStats const *s = &l_irq[i].st;
+        if (s->arrivals == 0U) {
+            continue;
+        }
+        fprintf(out, "%4u %9u %6.2f %11.1f %11.1f %8u\n", (unsigned)i,
+                (unsigned)s->arrivals, 100.0 * (double)s->busy / total,
+                (s->runs != 0U) ? us_(s->latencySum) / s->runs : 0.0,
+                us_(s->latencyMax), (unsigned)s->overruns);
+    }
+    if (l_traceLost != 0U) {
+        fprintf(out, "%u trace records missed, raise SST_TRACE_LEN_LOG2\n",
+                (unsigned)l_traceLost);
+    }
+}
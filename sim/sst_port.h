@@ -0,0 +1,140 @@
+/*****************************************************************************
+* SST port to a virtual-time simulator on POSIX hosts, GCC/Clang
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: This port runs the unmodified kernel, tasks and ISRs against a
+  virtual clock that counts target CPU cycles (SST_SIM_HZ). Time passes
+  only where the code says it does: a task or an ISR declares what it
+  costs with SST_simCost(), and the idle loop, SST_simRun(), jumps to the
+  next interrupt arrival. The arrivals come from a script (SST_simArrive(),
+  SST_simPeriodic()) or from a recorded trace file (SST_simLoad()); an
+  arrival that falls inside a declared cost preempts the code at that
+  cycle, and its ISR runs nested on the same stack with the usual
+  SST_ISR_ENTRY()/SST_ISR_EXIT() pattern, exactly like on the target.
+  An ISR preempts the tasks and the ISRs of a lower ISR priority. While
+  interrupts are locked, or a higher ISR runs, the arrival is latched like
+  in an interrupt controller and a second arrival of the same irq is an
+  overrun; SST_INT_UNLOCK() runs the latched ISRs.
+  The simulator learns what the kernel does from its trace (SST_TRACE,
+  always on in this port): posts, lost posts, dispatches and completions.
+  From it SST_simReport() gives per task the response time of the events,
+  from the post to the end of the run to completion, the queue occupancy
+  and the lost posts, and per irq the latency from the arrival to the ISR.
+  The kernel itself takes no virtual time. Everything is a function of the
+  script and SST_simSeed(), so a run is repeatable to the cycle.
+  Put this directory before include/ on the include path.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#ifndef sst_port_h
+#define sst_port_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+                                         /* SST interrupt locking/unlocking */
+#define SST_INT_LOCK()   do { \
+    SST_simIntLocked_ = 1; \
+    __asm__ __volatile__ ("" ::: "memory"); \
+} while (0)
+#define SST_INT_UNLOCK() do { \
+    __asm__ __volatile__ ("" ::: "memory"); \
+    SST_simIntLocked_ = 0; \
+    if (SST_simIrqPending_ != 0U) { \
+        SST_simIrqReplay_(); \
+    } \
+} while (0)
+                                               /* maximum SST task priority */
+#ifndef SST_MAX_PRIO
+#define SST_MAX_PRIO     32
+#endif
+#define SST_KERNEL_TLS                             /* one kernel, one thread */
+
+#define os_printf        printf            /* SDK services used by the kernel */
+#define os_memcpy        memcpy
+
+#define SST_MEM_BARRIER()      __asm__ __volatile__ ("" ::: "memory")
+#define SST_MEM_FULL_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+                        /* the virtual clock, in cycles of the target CPU */
+#ifndef SST_SIM_HZ
+#define SST_SIM_HZ       80000000U                 /* ESP8266 at 80MHz */
+#endif
+#define SST_SIM_US(us_)  ((uint64_t)(us_) * (SST_SIM_HZ / 1000000U))
+#define SST_CYCLES()     ((uint32_t)SST_simNow_)
+#define SST_CYCLES_HZ    SST_SIM_HZ
+
+#define SST_SIM_IRQS     16                           /* interrupt lines */
+
+                       /* the simulator reads the kernel trace, see above */
+#ifndef SST_TRACE
+#define SST_TRACE
+#endif
+#ifndef SST_TRACE_LEN_LOG2
+#define SST_TRACE_LEN_LOG2 12       /* records between two SST_simCost() */
+#endif
+
+typedef void (*SSTSimIsr)(void);
+
+typedef struct SSTSimTaskStatsTag SSTSimTaskStats;
+struct SSTSimTaskStatsTag {
+    uint64_t busy;                /* cycles of SST_simCost() of the task */
+    uint64_t respSum;                  /* sum of the response times */
+    uint64_t respMax;                     /* longest response time */
+    uint64_t queueArea;   /* queued events integrated over the cycles */
+    uint32_t events;                       /* events run to completion */
+    uint32_t drops;                         /* posts lost on a full queue */
+    uint16_t queueMax;                        /* most events queued */
+};
+
+typedef struct SSTSimIrqStatsTag SSTSimIrqStats;
+struct SSTSimIrqStatsTag {
+    uint64_t busy;           /* cycles of the ISR, entry cost included */
+    uint64_t latencySum;          /* arrival to the start of the ISR */
+    uint64_t latencyMax;
+    uint32_t arrivals;
+    uint32_t runs;                                  /* ISRs that ran */
+    uint32_t overruns;      /* arrivals lost while the irq was latched */
+};
+
+void SST_simIrqAttach(uint8_t irq, uint8_t isrPrio, SSTSimIsr isr,
+                      uint32_t cost);             /* cost: entry and exit */
+uint8_t SST_simArrive(uint64_t at, uint8_t irq, uint8_t par);
+uint8_t SST_simPeriodic(uint8_t irq, uint8_t par, uint64_t phase,
+                        uint64_t period, uint64_t jitter);
+int32_t SST_simLoad(char const *path);
+void SST_simSeed(uint32_t seed);             /* for the periodic jitter */
+void SST_simCost(uint32_t cycles);        /* the caller runs that long */
+void SST_simRun(uint64_t until);           /* the idle loop, to 'until' */
+uint64_t SST_simNow(void);
+uint8_t SST_simIrqPar(void);           /* 'par' of the arrival, in the ISR */
+SSTSimTaskStats const *SST_simTaskStats(uint8_t prio);
+SSTSimIrqStats const *SST_simIrqStats(uint8_t irq);
+uint32_t SST_simTraceLost(void);      /* records the simulator missed */
+void SST_simReport(FILE *out);
+void SST_simIrqReplay_(void);
+
+extern uint64_t SST_simNow_;
+extern volatile uint8_t  SST_simIntLocked_;
+extern volatile uint32_t SST_simIrqPending_;
+
+#include "sst.h"                      /* SST platform-independent interface */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif                                                        /* sst_port_h */
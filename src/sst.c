@@ -29,57 +29,78 @@
 
 #include "sst_port.h"
 #include "sst_exa.h"
-#include "c_types.h"
-#include "osapi.h"
-#include "mem.h"
 
 /* Public-scope objects ----------------------------------------------------*/
-uint8_t SST_currPrio_ = (uint8_t)0xFF;              /* current SST priority */
-#if SST_MAX_PRIO == 64
-uintX_t SST_readySet_ = (uintX_t)UINT64_C(0x0000000000000000);                        /* SST ready-set */
-#else
-uintX_t SST_readySet_ = (uintX_t)0;
+SSTKernel SST_kernel0_ = {           /* the tables and the ready set clear */
+  .currPrio__ = (uint8_t)0xFF,                      /* current SST priority */
+  #ifdef SST_EVT_POOL
+  .evtFree__ = SST_EVT_NIL,                     /* free list of the pool */
+  #endif
+};
+#if SST_MAX_KERNELS > 1
+SST_KERNEL_TLS SSTKernel *SST_kernel_ = &SST_kernel0_;
 #endif
 
-typedef struct TaskCBTag TaskCB;
-struct TaskCBTag {
-  SSTTask task__;                 // Pointer to the task
-  SSTEvent lastEvent__;           // Used when task is "suspended"
-  SSTEvent *queue__;              // Event queue
-  uint8_t end__;                  // The length of the queue
-  uint8_t head__;                 // Points to the head (start or ) of the queue
-  uint8_t tail__;                 // and the tail
-  uint8_t nUsed__;
-  uintX_t mask__;
-};
+typedef SSTTaskCB TaskCB;
 
-/* Local-scope objects -----------------------------------------------------*/
-static TaskCB l_taskCB[SST_MAX_PRIO];
+/* NOTE: with SST_MAX_TASKS the control blocks are a dense array sized to the
+* number of tasks and taskIdx__[] maps a priority to its block. Index 0 is
+* a block without a task and a queue, so posts to an unused priority fail
+* as they do in the table indexed by priority.
+*/
+#ifdef SST_MAX_TASKS
+#define TCB_(prio_) \
+    (&SST_kernel_->taskCB__[SST_kernel_->taskIdx__[(prio_) - 1]])
+#else
+#define TCB_(prio_)  (&SST_kernel_->taskCB__[(prio_) - 1])
+#endif
+#ifdef SST_EVT_POOL
+#define NODE_(i_)    (SST_kernel_->evtNode__[(i_)])
+#endif
 
 /*..........................................................................*/
 void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
   SSTSignal sig, SSTParam par)
   {
     SSTEvent ie;                                    /* initialization event */
-    TaskCB *tcb  = &l_taskCB[prio - 1];
+    TaskCB *tcb;
+    #ifdef SST_MAX_TASKS
+    if (SST_kernel_->taskIdx__[prio - 1] == (uint8_t)0) { /* a new prio? */
+      if (SST_kernel_->nTasks__ == (uint8_t)SST_MAX_TASKS) {
+        SST_LOG(SST_LOG_NO_TCB, prio, SST_MAX_TASKS);
+        return;
+      }
+      SST_kernel_->taskIdx__[prio - 1] = ++SST_kernel_->nTasks__;
+    }
+    #endif
+    tcb = TCB_(prio);
     tcb->task__  = task;
     tcb->queue__ = queue;
     tcb->end__   = qlen;
     tcb->head__  = (uint8_t)0;
     tcb->tail__  = (uint8_t)0;
     tcb->nUsed__ = (uint8_t)0;
-    #if SST_MAX_PRIO == 64
-    tcb->mask__  = (UINT64_C(0x0000000000000001) << (prio - 1));
-    #else
-    tcb->mask__  = (1 << (prio - 1));
+    tcb->wake__  = (uint8_t)0;
+    tcb->ovf__   = (uint8_t)SST_OVF_REJECT_NEWEST;
+    #ifdef SST_EVT_POOL
+    tcb->first__ = SST_EVT_NIL;
     #endif
     ie.sig = sig;
     ie.par = par;
+    #ifdef SST_DYN_POOLS
+    ie.dyn = (SSTDynEvt *)0;
+    #endif
     tcb->lastEvent__ = ie;
     tcb->task__(ie);                                 /* initialize the task */
   }
   /*..........................................................................*/
   void SST_run(void) {
+    #ifdef SST_STATS
+    SST_statsReset();                       /* the statistics start here */
+    #endif
+    #ifdef SST_STACK_PROF
+    SST_stackBase_ = SST_STACK_SP();         /* the first base of the depths */
+    #endif
     SST_start();                                              /* start ISRs */
 
     SST_INT_LOCK();
@@ -92,32 +113,485 @@ void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
     //}
   }
   /*..........................................................................*/
-  uint8_t SST_post(uint8_t prio, SSTSignal sig, SSTParam par) {
-    TaskCB *tcb = &l_taskCB[prio - 1];
+  void SST_taskOverflow(uint8_t prio, uint8_t policy) {
+    SST_INT_LOCK();
+    TCB_(prio)->ovf__ = policy;
+    SST_INT_UNLOCK();
+  }
+  /*..........................................................................*/
+  uint16_t SST_overflowDrops(uint8_t policy) {
+    uint16_t n;
+    SST_INT_LOCK();
+    n = SST_kernel_->ovfDrops__[policy];
+    SST_INT_UNLOCK();
+    return n;
+  }
+  #ifdef SST_EVT_POOL
+  /*..........................................................................*/
+  /* NOTE: with SST_EVT_POOL the private queue of a task is only its reserve.
+  * When it is full the task borrows nodes of the shared pool, linked oldest
+  * first from first__ to last__, and gives them back as it consumes its
+  * events, so the ring stays full while the task holds pool nodes.
+  */
+  void SST_evtPoolInit(SSTEvtNode *nodes, uint8_t n) {
+    uint8_t i;
     SST_INT_LOCK();
+    SST_kernel_->evtNode__ = nodes;
+    SST_kernel_->evtFree__ = SST_EVT_NIL;
+    for (i = n; i != (uint8_t)0; --i) {           /* thread the free list */
+      nodes[i - 1U].next__ = SST_kernel_->evtFree__;
+      SST_kernel_->evtFree__ = (uint8_t)(i - 1U);
+    }
+    SST_kernel_->evtUsed__ = (uint8_t)0;
+    SST_kernel_->evtMaxUsed__ = (uint8_t)0;
+    SST_kernel_->evtFails__ = (uint16_t)0;
+    SST_INT_UNLOCK();
+  }
+  /*..........................................................................*/
+  uint8_t SST_evtPoolUsed(void) {
+    return SST_kernel_->evtUsed__;
+  }
+  /*..........................................................................*/
+  uint8_t SST_evtPoolMaxUsed(void) {                    /* high-water mark */
+    return SST_kernel_->evtMaxUsed__;
+  }
+  /*..........................................................................*/
+  uint16_t SST_evtPoolFails(void) {      /* posts that found the pool empty */
+    return SST_kernel_->evtFails__;
+  }
+  /*..........................................................................*/
+  static uint8_t nodeGet_(void) {
+    uint8_t i = SST_kernel_->evtFree__;
+    if (i != SST_EVT_NIL) {
+      SST_kernel_->evtFree__ = NODE_(i).next__;
+      if ((++SST_kernel_->evtUsed__) > SST_kernel_->evtMaxUsed__) {
+        SST_kernel_->evtMaxUsed__ = SST_kernel_->evtUsed__;
+      }
+    }
+    else {
+      ++SST_kernel_->evtFails__;
+    }
+    return i;
+  }
+  /*..........................................................................*/
+  static void nodePut_(uint8_t i) {
+    NODE_(i).next__ = SST_kernel_->evtFree__;
+    SST_kernel_->evtFree__ = i;
+    --SST_kernel_->evtUsed__;
+  }
+  #endif                                                    /* SST_EVT_POOL */
+  /*..........................................................................*/
+  /* NOTE: the queue primitives below keep the oldest event at the tail__ of
+  * the ring and must be called with interrupts LOCKED. put_() queues the
+  * event at the head, or at the tail when 'urgent' so that it is the next
+  * one dequeued, and returns 0 when there is no room.
+  */
+  static inline uint8_t put_(TaskCB *tcb, SSTEvent const *e,
+                             uint8_t urgent) {
     if (tcb->nUsed__ < tcb->end__) {
-      tcb->queue__[tcb->head__].sig = sig;/* insert the event at the head */
-      tcb->queue__[tcb->head__].par = par;
-      if ((++tcb->head__) == tcb->end__) {
-        tcb->head__ = (uint8_t)0;                      /* wrap the head */
+      if (urgent) {
+        if (tcb->tail__ == (uint8_t)0) {
+          tcb->tail__ = tcb->end__;                    /* wrap the tail */
+        }
+        tcb->queue__[--tcb->tail__] = *e;  /* insert the event at the tail */
       }
-      if ((++tcb->nUsed__) == (uint8_t)1) {           /* the first event? */
-        SST_readySet_ |= tcb->mask__;   /* insert task to the ready set */
-        SST_schedule_();            /* check for synchronous preemption */
+      else {
+        tcb->queue__[tcb->head__] = *e;     /* insert the event at the head */
+        if ((++tcb->head__) == tcb->end__) {
+          tcb->head__ = (uint8_t)0;                    /* wrap the head */
+        }
       }
-      SST_INT_UNLOCK();
-      return (uint8_t)1;                     /* event successfully posted */
     }
     else {
-      SST_INT_UNLOCK();
+      #ifdef SST_EVT_POOL
+      uint8_t i;
+      if (tcb->task__ == (SSTTask)0) {
+        return (uint8_t)0;                   /* no task at this priority */
+      }
+      i = nodeGet_();
+      if (i == SST_EVT_NIL) {
+        return (uint8_t)0;                /* the reserve and the pool full */
+      }
+      if (!urgent) {                   /* append to the borrowed nodes */
+        NODE_(i).e = *e;
+        NODE_(i).next__ = SST_EVT_NIL;
+        if (tcb->first__ == SST_EVT_NIL) {
+          tcb->first__ = i;
+        }
+        else {
+          NODE_(tcb->last__).next__ = i;
+        }
+        tcb->last__ = i;
+      }
+      else {  /* the newest of the ring moves to the front of the nodes */
+        if (tcb->end__ == (uint8_t)0) {
+          NODE_(i).e = *e;
+        }
+        else {
+          uint8_t h = (uint8_t)(((tcb->head__ == (uint8_t)0)
+                                 ? tcb->end__ : tcb->head__) - 1U);
+          NODE_(i).e = tcb->queue__[h];
+          tcb->queue__[h] = *e;
+          tcb->head__ = h;
+          tcb->tail__ = h;
+        }
+        NODE_(i).next__ = tcb->first__;
+        if (tcb->first__ == SST_EVT_NIL) {
+          tcb->last__ = i;
+        }
+        tcb->first__ = i;
+      }
+      #else
+      return (uint8_t)0;                                /* the queue full */
+      #endif
+    }
+    ++tcb->nUsed__;
+    return (uint8_t)1;
+  }
+  /*..........................................................................*/
+  static inline void take_(TaskCB *tcb, SSTEvent *e) {  /* the oldest event */
+    #ifdef SST_EVT_POOL
+    uint8_t i = tcb->first__;
+    if (i != SST_EVT_NIL) {
+      tcb->first__ = NODE_(i).next__;
+      if (tcb->end__ == (uint8_t)0) {
+        *e = NODE_(i).e;                     /* no reserve, no ring */
+      }
+      else {
+        *e = tcb->queue__[tcb->tail__];
+        tcb->queue__[tcb->tail__] = NODE_(i).e; /* the ring stays full */
+        if ((++tcb->tail__) == tcb->end__) {
+          tcb->tail__ = (uint8_t)0;
+        }
+        tcb->head__ = tcb->tail__;
+      }
+      nodePut_(i);
+      --tcb->nUsed__;
+      return;
+    }
+    #endif
+    *e = tcb->queue__[tcb->tail__];
+    if ((++tcb->tail__) == tcb->end__) {
+      tcb->tail__ = (uint8_t)0;
+    }
+    --tcb->nUsed__;
+  }
+  /*..........................................................................*/
+  static SSTEvent *oldest_(TaskCB *tcb) {
+    #ifdef SST_EVT_POOL
+    if (tcb->end__ == (uint8_t)0) {
+      return &NODE_(tcb->first__).e;
+    }
+    #endif
+    return &tcb->queue__[tcb->tail__];
+  }
+  /*..........................................................................*/
+  static SSTEvent *newest_(TaskCB *tcb) {
+    #ifdef SST_EVT_POOL
+    if (tcb->first__ != SST_EVT_NIL) {
+      return &NODE_(tcb->last__).e;
+    }
+    #endif
+    return &tcb->queue__[((tcb->head__ == (uint8_t)0)
+                          ? tcb->end__ : tcb->head__) - 1U];
+  }
+  /*..........................................................................*/
+  /* NOTE: dropNewest_() is O(1) on the ring but walks the borrowed nodes */
+  static void dropNewest_(TaskCB *tcb) {
+    #ifdef SST_EVT_POOL
+    uint8_t i = tcb->first__;
+    if (i != SST_EVT_NIL) {
+      uint8_t last = tcb->last__;
+      if (i == last) {
+        tcb->first__ = SST_EVT_NIL;
+      }
+      else {
+        while (NODE_(i).next__ != last) {
+          i = NODE_(i).next__;
+        }
+        NODE_(i).next__ = SST_EVT_NIL;
+        tcb->last__ = i;
+      }
+      nodePut_(last);
+      --tcb->nUsed__;
+      return;
+    }
+    #endif
+    tcb->head__ = (uint8_t)(((tcb->head__ == (uint8_t)0)
+                             ? tcb->end__ : tcb->head__) - 1U);
+    --tcb->nUsed__;
+  }
+  /*..........................................................................*/
+  /* NOTE: findSig_() returns the newest queued event with the signal 'sig'
+  * or NULL. It is only called on a full queue, so the ring is full.
+  */
+  static SSTEvent *findSig_(TaskCB *tcb, SSTSignal sig) {
+    SSTEvent *found = (SSTEvent *)0;
+    uint8_t i = tcb->head__;
+    uint8_t n;
+    #ifdef SST_EVT_POOL
+    uint8_t k;
+    for (k = tcb->first__; k != SST_EVT_NIL; k = NODE_(k).next__) {
+      if (NODE_(k).e.sig == sig) {
+        found = &NODE_(k).e;
+      }
+    }
+    if (found != (SSTEvent *)0) {
+      return found;
+    }
+    #endif
+    for (n = tcb->end__; n != (uint8_t)0; --n) {
+      i = (uint8_t)(((i == (uint8_t)0) ? tcb->end__ : i) - 1U);
+      if (tcb->queue__[i].sig == sig) {
+        return &tcb->queue__[i];
+      }
+    }
+    return found;
+  }
+  /*..........................................................................*/
+  /* NOTE: enqueue_() queues the event with put_() and inserts the task to
+  * the set 'ready' if it is the first event. When the queue is full the
+  * task's overflow policy decides which event is lost; an urgent event
+  * that coalesces takes the place of the queued one. It must be called
+  * with interrupts LOCKED and does not invoke the scheduler. The
+  * multi-target posts collect the new ready tasks in a local set and merge
+  * it into SST_readySet_ with a single update.
+  */
+  static uint8_t enqueue_(TaskCB *tcb, uint8_t prio, SSTEvent const *e,
+                          SSTPrioSet *ready, uint8_t urgent) {
+    SSTEvent *slot = (SSTEvent *)0;
+    SSTEvent lost;
+    if (put_(tcb, e, urgent)) {
+      SST_TRACE_REC(SST_TRC_POST, prio, e->sig);
+      #ifdef SST_STATS
+      SST_statsPost_(prio, tcb->nUsed__, 1);
+      #endif
+      if (tcb->nUsed__ == (uint8_t)1) {               /* the first event? */
+        SST_prioSetInsert(ready, prio);          /* insert to ready set */
+      }
+      return (uint8_t)1;                     /* event successfully posted */
+    }
+    ++SST_kernel_->ovfDrops__[tcb->ovf__];
+    #ifdef SST_STATS
+    SST_statsPost_(prio, tcb->nUsed__, 0);
+    #endif
+    if (tcb->nUsed__ != (uint8_t)0) {       /* anything queued to give up? */
+      switch (tcb->ovf__) {
+        case SST_OVF_DROP_OLDEST:
+          slot = oldest_(tcb);
+          break;
+        case SST_OVF_OVERWRITE_LATEST:
+          slot = newest_(tcb);
+          break;
+        case SST_OVF_COALESCE:
+          slot = findSig_(tcb, e->sig);
+          break;
+        default:
+          break;
+      }
+    }
+    if (slot == (SSTEvent *)0) {
+      SST_TRACE_REC(SST_TRC_POST_FAIL, prio, e->sig);
+      SST_LOG_(SST_LOG_POST_FAIL, prio, e->sig);
       return (uint8_t)0;              /* queue full, event posting failed */
     }
+    SST_TRACE_REC(SST_TRC_POST_FAIL, prio, slot->sig);  /* the lost event */
+    SST_LOG_(SST_LOG_POST_FAIL, prio, slot->sig);
+    #ifdef SST_DYN_POOLS
+    if (slot->dyn == e->dyn) {
+      if (e->dyn != (SSTDynEvt *)0) {
+        --e->dyn->refCtr__;             /* the poster takes it right back */
+      }
+    }
+    else if (slot->dyn != (SSTDynEvt *)0) {
+      SST_dynGc_(slot->dyn);
+    }
+    #endif
+    SST_TRACE_REC(SST_TRC_POST, prio, e->sig);
+    if (tcb->ovf__ == (uint8_t)SST_OVF_DROP_OLDEST) {
+      take_(tcb, &lost);
+      (void)put_(tcb, e, urgent);                /* there is room now */
+    }
+    else if (urgent && (tcb->ovf__ == (uint8_t)SST_OVF_OVERWRITE_LATEST)) {
+      dropNewest_(tcb);
+      (void)put_(tcb, e, urgent);
+    }
+    else {
+      *slot = *e;                                    /* replace in place */
+    }
+    return (uint8_t)1;
+  }
+  /*..........................................................................*/
+  uint8_t SST_post(uint8_t prio, SSTSignal sig, SSTParam par) {
+    TaskCB *tcb = TCB_(prio);
+    SSTEvent e;
+    uint8_t ok;
+    e.sig = sig;
+    e.par = par;
+    #ifdef SST_DYN_POOLS
+    e.dyn = (SSTDynEvt *)0;
+    #endif
+    SST_INT_LOCK();
+    ok = enqueue_(tcb, prio, &e, &SST_readySet_, (uint8_t)0);
+    if (ok && (tcb->nUsed__ == (uint8_t)1)) {     /* the task became ready? */
+      SST_schedule_();              /* check for synchronous preemption */
+    }
+    SST_INT_UNLOCK();
+    return ok;
+  }
+  /*..........................................................................*/
+  /* NOTE: SST_postUrgent() queues the event ahead of all the events already
+  * queued (LIFO), e.g. for a cancel that must not wait behind stale work.
+  */
+  uint8_t SST_postUrgent(uint8_t prio, SSTSignal sig, SSTParam par) {
+    TaskCB *tcb = TCB_(prio);
+    SSTEvent e;
+    uint8_t ok;
+    e.sig = sig;
+    e.par = par;
+    #ifdef SST_DYN_POOLS
+    e.dyn = (SSTDynEvt *)0;
+    #endif
+    SST_INT_LOCK();
+    ok = enqueue_(tcb, prio, &e, &SST_readySet_, (uint8_t)1);
+    if (ok && (tcb->nUsed__ == (uint8_t)1)) {     /* the task became ready? */
+      SST_schedule_();              /* check for synchronous preemption */
+    }
+    SST_INT_UNLOCK();
+    return ok;
+  }
+  #ifdef SST_DYN_POOLS
+  /*..........................................................................*/
+  uint8_t SST_postDyn(uint8_t prio, SSTSignal sig, SSTDynEvt *dyn) {
+    TaskCB *tcb = TCB_(prio);
+    SSTEvent e;
+    uint8_t ok;
+    e.sig = sig;
+    e.par = (SSTParam)0;
+    e.dyn = dyn;
+    SST_INT_LOCK();
+    ok = enqueue_(tcb, prio, &e, &SST_readySet_, (uint8_t)0);
+    if (ok) {
+      ++dyn->refCtr__;                   /* the queued copy holds a reference */
+      if (tcb->nUsed__ == (uint8_t)1) {
+        SST_schedule_();            /* check for synchronous preemption */
+      }
+    }
+    SST_INT_UNLOCK();
+    return ok;
+  }
+  /*..........................................................................*/
+  /* NOTE: SST_multicastDyn() queues the event to every task in 'prios'
+  * under one lock before scheduling, and holds a guard reference for the
+  * whole fan-out, so no receiver can recycle it before all the others got
+  * it. Dropping the guard recycles the event only when no reference is
+  * left, i.e. nobody took it and no queue still holds it from an earlier
+  * post. Returns the number of receivers.
+  */
+  uint8_t SST_multicastDyn(SSTPrioSet const *prios, SSTSignal sig,
+                           SSTDynEvt *dyn) {
+    SSTPrioSet s = *prios;
+    SSTPrioSet ready;
+    SSTEvent e;
+    uint8_t n = (uint8_t)0;
+    uint8_t p;
+    e.sig = sig;
+    e.par = (SSTParam)0;
+    e.dyn = dyn;
+    SST_prioSetClear(&ready);
+    SST_INT_LOCK();
+    ++dyn->refCtr__;                                      /* guard reference */
+    while ((p = SST_prioSetFindMax(&s)) != (uint8_t)0) {
+      SST_prioSetRemove(&s, p);
+      if (enqueue_(TCB_(p), p, &e, &ready, (uint8_t)0)) {
+        ++dyn->refCtr__;
+        ++n;
+      }
+    }
+    if (!SST_prioSetIsEmpty(&ready)) {
+      SST_prioSetUnion(&SST_readySet_, &ready);
+      SST_schedule_();                 /* one pass for all the receivers */
+    }
+    SST_dynGc_(dyn);      /* drop the guard, recycles if nobody holds it */
+    SST_INT_UNLOCK();
+    return n;
+  }
+  #endif
+  /*..........................................................................*/
+  /* NOTE: SST_postBatch() posts every tuple of 'posts' under a single
+  * critical section and then runs the scheduler once, so a higher-priority
+  * receiver runs only after all the events are queued. The result of each
+  * post is stored in posts[i].ok; returns the number of events posted.
+  */
+  uint8_t SST_postBatch(SSTPost *posts, uint8_t n) {
+    SSTPrioSet ready;
+    uint8_t nOk = (uint8_t)0;
+    uint8_t i;
+    SSTEvent e;
+    #ifdef SST_DYN_POOLS
+    e.dyn = (SSTDynEvt *)0;
+    #endif
+    SST_prioSetClear(&ready);
+    SST_INT_LOCK();
+    for (i = (uint8_t)0; i < n; ++i) {
+      e.sig = posts[i].sig;
+      e.par = posts[i].par;
+      posts[i].ok = enqueue_(TCB_(posts[i].prio), posts[i].prio, &e, &ready,
+                             (uint8_t)0);
+      nOk += posts[i].ok;
+    }
+    if (!SST_prioSetIsEmpty(&ready)) {
+      SST_prioSetUnion(&SST_readySet_, &ready);
+      SST_schedule_();                  /* one pass for the whole batch */
+    }
+    SST_INT_UNLOCK();
+    return nOk;
+  }
+  /*..........................................................................*/
+  /* NOTE: SST_postMask() posts the same event to every task in 'prios' with
+  * one critical section and one scheduling pass. The tasks whose queue was
+  * full are returned in 'failed' (when not NULL); returns the number of
+  * events posted.
+  */
+  uint8_t SST_postMask(SSTPrioSet const *prios, SSTSignal sig, SSTParam par,
+                       SSTPrioSet *failed) {
+    SSTPrioSet s = *prios;
+    SSTPrioSet ready;
+    uint8_t nOk = (uint8_t)0;
+    uint8_t p;
+    SSTEvent e;
+    e.sig = sig;
+    e.par = par;
+    #ifdef SST_DYN_POOLS
+    e.dyn = (SSTDynEvt *)0;
+    #endif
+    if (failed != (SSTPrioSet *)0) {
+      SST_prioSetClear(failed);
+    }
+    SST_prioSetClear(&ready);
+    SST_INT_LOCK();
+    while ((p = SST_prioSetFindMax(&s)) != (uint8_t)0) {
+      SST_prioSetRemove(&s, p);
+      if (enqueue_(TCB_(p), p, &e, &ready, (uint8_t)0)) {
+        ++nOk;
+      }
+      else if (failed != (SSTPrioSet *)0) {
+        SST_prioSetInsert(failed, p);
+      }
+    }
+    if (!SST_prioSetIsEmpty(&ready)) {
+      SST_prioSetUnion(&SST_readySet_, &ready);    /* one ready-set update */
+      SST_schedule_();
+    }
+    SST_INT_UNLOCK();
+    return nOk;
   }
   /*..........................................................................*/
   uint8_t SST_mutexLock(uint8_t prioCeiling) {
     uint8_t p;
     SST_INT_LOCK();
     p = SST_currPrio_;               /* the original SST priority to return */
+    SST_TRACE_REC(SST_TRC_MUTEX_LOCK, prioCeiling, p);
     if (prioCeiling > SST_currPrio_) {
       SST_currPrio_ = prioCeiling;              /* raise the SST priority */
     }
@@ -127,6 +601,7 @@ void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
   /*..........................................................................*/
   void SST_mutexUnlock(uint8_t orgPrio) {
     SST_INT_LOCK();
+    SST_TRACE_REC(SST_TRC_MUTEX_UNLOCK, orgPrio, 0);
     if (orgPrio < SST_currPrio_) {
       SST_currPrio_ = orgPrio;    /* restore the saved priority to unlock */
       SST_schedule_();    /* invoke scheduler after lowering the priority */
@@ -134,116 +609,174 @@ void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
     SST_INT_UNLOCK();
   }
 
-  uint8_t log2Lkup(uintX_t rs){
-    uint8_t n = 0;
-    #if SST_MAX_PRIO == 64
-    uintX_t b = UINT64_C(0x0000000000000001) << (SST_MAX_PRIO - 1);
-    #else
-    uintX_t b = 1 << (SST_MAX_PRIO - 1);
-    #endif
-    while (n < SST_MAX_PRIO) {
-      if (rs & (b >> n)) {
-        return SST_MAX_PRIO-n;
-      }
-      n++;
-    }
-    return 0;
-  }
-
   /*..........................................................................*/
   /* NOTE: SST_schedule_() the SST scheduler is entered and exited with interrupts LOCKED */
   void SST_schedule_(void) {
-    // static uint8_t const log2Lkup[] = {
-    //     0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4,
-    //     5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-    //     6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-    //     6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
-    //     7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-    //     7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-    //     7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-    //     7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
-    //     8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8
-    // };
     uint8_t pin = SST_currPrio_;               /* save the initial priority */
     uint8_t p;                                          /* the new priority */
+    #ifdef SST_STATS
+    uint8_t run;                         /* the task charged before p runs */
+    #endif
     /* is the new priority higher than the initial? */
-    while ((p = log2Lkup(SST_readySet_)) > pin) {
-      TaskCB *tcb  = &l_taskCB[p - 1];
-      /* get the event out of the queue */
-      SSTEvent e = tcb->queue__[tcb->tail__];
-      tcb->lastEvent__ = e; // save the last executed event
-      if ((++tcb->tail__) == tcb->end__) {
-        tcb->tail__ = (uint8_t)0;
+    while ((p = SST_prioSetFindMax(&SST_readySet_)) > pin) {
+      TaskCB *tcb  = TCB_(p);
+      SSTEvent e;
+      if (tcb->wake__ != (uint8_t)0) {      /* semaphore wakeup pending? */
+        --tcb->wake__;
+        e.sig = SIGNAL_SEM_SIG;   /* re-run the task with its last event */
+        e.par = tcb->lastEvent__.par;
+        #ifdef SST_DYN_POOLS
+        e.dyn = (SSTDynEvt *)0;
+        #endif
+      }
+      else {
+        take_(tcb, &e);                   /* get the event out of the queue */
+        tcb->lastEvent__ = e; // save the last executed event
       }
-      if ((--tcb->nUsed__) == (uint8_t)0) {/* is the queue becoming empty?*/
-        SST_readySet_ &= ~tcb->mask__;     /* remove from the ready set */
+      if ((tcb->nUsed__ == (uint8_t)0) && (tcb->wake__ == (uint8_t)0)) {
+        SST_prioSetRemove(&SST_readySet_, p);  /* remove from ready set */
       }
+      SST_TRACE_REC((pin == (uint8_t)0) ? SST_TRC_DISPATCH : SST_TRC_PREEMPT,
+                    p, e.sig);
+      #ifdef SST_STATS
+      run = SST_statsDispatch_(p);
+      #endif
+      #ifdef SST_STACK_PROF
+      SST_stackDispatch_(p);
+      #endif
       SST_currPrio_ = p;        /* this becomes the current task priority */
       SST_INT_UNLOCK();                          /* unlock the interrupts */
 
       (*tcb->task__)(e);                             /* call the SST task */
 
       SST_INT_LOCK();            /* lock the interrupts for the next pass */
+      SST_TRACE_REC(SST_TRC_DONE, p, e.sig);
+      #ifdef SST_STATS
+      SST_statsDone_(p, run);
+      #endif
+      #ifdef SST_STACK_PROF
+      SST_stackDone_();
+      #endif
+      #ifdef SST_DYN_POOLS
+      if (e.dyn != (SSTDynEvt *)0) {
+        SST_dynGc_(e.dyn);           /* release the task's reference */
+      }
+      #endif
     }
     SST_currPrio_ = pin;                    /* restore the initial priority */
   }
 
-  void SST_initSemaphore(Semaphore *s) {
-    SST_INT_LOCK();
-    s->c = 1;
-    #if SST_MAX_PRIO == 64
-    s->queue = (uintX_t) UINT64_C(0x0000000000000000);
+  /*..........................................................................*/
+  /* NOTE: wakeTask_() makes the task 'p' ready to run once more with
+  * SIGNAL_SEM_SIG and its last event's parameter. The wakeup is counted in
+  * the task control block and not posted to the task's event queue, so it
+  * cannot be lost when the queue is full. It must be called with interrupts
+  * LOCKED and does not invoke the scheduler.
+  */
+  static void wakeTask_(uint8_t p) {
+    SST_TRACE_REC(SST_TRC_SEM_WAKE, p, 0);
+    SST_LOG_(SST_LOG_SEM_WAKE, p, 0);
+    ++TCB_(p)->wake__;
+    SST_prioSetInsert(&SST_readySet_, p);
+  }
+
+  /*  NOTE: canBlock_() tells if the caller is a task, which can wait on a
+  *  semaphore. The idle loop (0) and ISRs (0xFF) are not tasks.
+  */
+  static inline uint8_t canBlock_(void) {
+    #if SST_MAX_PRIO < 0xFF
+    return (uint8_t)((SST_currPrio_ != (uint8_t)0)
+                     && (SST_currPrio_ <= (uint8_t)SST_MAX_PRIO));
     #else
-    s->queue = (uintX_t) 0;
+    return (uint8_t)((SST_currPrio_ != (uint8_t)0)
+                     && (SST_currPrio_ != (uint8_t)0xFF));
     #endif
+  }
+
+  void SST_initSemaphore(Semaphore *s) {
+    SST_initSemCounting(s, 1, 1);
+  }
+
+  /*  NOTE: SST_initSemCounting(s, count, max) initializes a counting
+  *  semaphore with 'count' tokens, which can grow up to 'max' tokens.
+  *  SST_initSemaphore(s) is the binary semaphore (1, 1).
+  */
+  void SST_initSemCounting(Semaphore *s, uint8_t count, uint8_t max) {
+    SST_INT_LOCK();
+    s->c = (count < max) ? count : max;
+    s->max = max;
+    SST_prioSetClear(&s->queue);
+    SST_prioSetClear(&s->granted);
     SST_INT_UNLOCK();
   }
 
+  /*  NOTE: SST_wait(s) takes a token and returns 1, or returns 0 and adds
+  *  the current task to the semaphore's queue. A task that was handed a
+  *  token by SST_signal() gets that token here, before any other task can
+  *  take the remaining ones.
+  */
   uint8_t SST_wait(Semaphore *s) {
     SST_INT_LOCK();
+    if (canBlock_() && SST_prioSetHas(&s->granted, SST_currPrio_)) {
+      SST_prioSetRemove(&s->granted, SST_currPrio_);  // The handed token
+      SST_INT_UNLOCK();
+      return 1;
+    }
     if (s->c > 0) {  // Is semaphore available?
-      s->c = 0;
+      --s->c;
+      SST_INT_UNLOCK();
       return 1; // Semaphore was successfully taken by the running task
     }
-    TaskCB *tcb  = &l_taskCB[SST_currPrio_ - 1];  // Get the current the TCB of current running task
-    s->queue |= tcb->mask__;  // Add the task to the semaphore queue
+    if (canBlock_()) {
+      SST_TRACE_REC(SST_TRC_SEM_BLOCK, SST_currPrio_, s->c);
+      SST_prioSetInsert(&s->queue, SST_currPrio_);  // Add the current task to the semaphore queue
+    }
     SST_INT_UNLOCK();
     return 0;  // Semaphore is unavailable so task will be blocked
   }
 
   /*
-  *  NOTE: SST_signal(s) This function should be called only when a semaphore
-  *  has been taken.
-  *  If there is some task in the queue wanting to get access
-  *  on the semaphore, it will be called with the semaphore
-  *  available (s->c = 1), so it can take the semaphore during
-  *  its execution
+  *  NOTE: SST_signal(s) releases one token. If some task is in the queue
+  *  waiting on the semaphore, the token is handed directly to the highest
+  *  priority one, which is woken with SIGNAL_SEM_SIG and takes the token
+  *  in its next SST_wait(s). Otherwise the count is incremented; returns 0
+  *  when the count is already at its maximum and the token is dropped.
   */
-
-  void SST_signal(Semaphore *s) {
+  uint8_t SST_signal(Semaphore *s) {
+    uint8_t ok = 1;
     SST_INT_LOCK();
     // Test if the queue is empty
-    if (s->queue == 0) {
-      s->c = 1;
+    if (SST_prioSetIsEmpty(&s->queue)) {
+      if (s->c < s->max) {
+        ++s->c;
+      }
+      else {
+        ok = 0;
+      }
     }
-    // Should call the highest priority task waiting on this semaphore
-    // Call task waiting on semaphore
+    // Hand the token to the highest priority task waiting on this semaphore
     else {
-      uint8_t p = log2Lkup(s->queue);   // Get the highest priority "blocked" task
-      os_printf("DEBUG: CALL TASK %d THAT WAS SUSPENDED.\n", p);
-      s->queue &= ~(1 << (p - 1));  // Remove this task from the queue
-      TaskCB *tcb  = &l_taskCB[p - 1];
-      s->c = 1; // this is necessary as it was explained above
-      SST_post(p, SIGNAL_SEM_SIG, (tcb->lastEvent__.par));
+      uint8_t p = SST_prioSetFindMax(&s->queue);   // Get the highest priority "blocked" task
+      SST_prioSetRemove(&s->queue, p);  // Remove this task from the queue
+      SST_prioSetInsert(&s->granted, p);
+      wakeTask_(p);
+      SST_schedule_();              /* check for synchronous preemption */
     }
     SST_INT_UNLOCK();
+    return ok;
+  }
+
+  /*  NOTE: semWake_(s) wakes the highest priority task waiting on s without
+  *  handing it a token, for the waiters of a queue's data or space. It must
+  *  be called with interrupts LOCKED.
+  */
+  static void semWake_(Semaphore *s) {
+    uint8_t p = SST_prioSetFindMax(&s->queue);
+    if (p != (uint8_t)0) {
+      SST_prioSetRemove(&s->queue, p);
+      wakeTask_(p);
+      SST_schedule_();
+    }
   }
 
   void SST_initMailbox(Mailbox *mb) {
@@ -261,8 +794,15 @@ void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
   * queue has no data available or no more space).
   */
   void addTaskSemQueue(Semaphore *sem) {
-    TaskCB *tcb  = &l_taskCB[SST_currPrio_ - 1];  // Get the current the TCB of current running task
-    sem->queue |= tcb->mask__; // Add the task to the semaphore queue
+    if (!canBlock_()) {
+      return;
+    }
+    if (SST_prioSetHas(&sem->granted, SST_currPrio_)) {
+      SST_prioSetRemove(&sem->granted, SST_currPrio_);  // Return an unused
+      ++sem->c;                                         // handed token
+    }
+    SST_TRACE_REC(SST_TRC_SEM_BLOCK, SST_currPrio_, sem->c);
+    SST_prioSetInsert(&sem->queue, SST_currPrio_); // Add the current task to the semaphore queue
   }
 
   /*  NOTE: SST_send(mb, data) Data passed to the mailbox in the function below should be a
@@ -281,7 +821,7 @@ void SST_task(SSTTask task, uint8_t prio, SSTEvent *queue, uint8_t qlen,
       }
     } else {        // mailbox is already full, so the task will be "blocked"
     SST_INT_LOCK(); // and will wait until the mailbox is empty again
-    os_printf("DEBUG: MAILBOX IS FULL!\n");
+    SST_LOG_(SST_LOG_MB_FULL, SST_currPrio_, 0);
     addTaskSemQueue(&(mb->sem));
     SST_INT_UNLOCK();
   }
@@ -301,24 +841,64 @@ uint8_t SST_receive(Mailbox *mb, uint8_t *data) {
     }
   } else {  // there is no data available, so the task will be "suspended"
   SST_INT_LOCK();
-  os_printf("DEBUG: NO DATA AVAILABLE!\n");
+  SST_LOG_(SST_LOG_MB_EMPTY, SST_currPrio_, 0);
   addTaskSemQueue(&(mb->sem));
   SST_INT_UNLOCK();
 }
 return w;
 }
 
-void SST_initQueue(Queue *q, uint8_t size) {
+/*  NOTE: SST_initQueueElem(q, size, elemSize) The queue holds 'size'
+*  elements of 'elemSize' bytes each. The buffer is allocated from the
+*  kernel memory partitions (see SST_memInit), so the application must have
+*  registered a partition with blocks of at least size*elemSize bytes.
+*  Returns 0 when no block is available. When 'size' is a power of two the
+*  indexes wrap with a mask, otherwise with a compare; never with '%'.
+*/
+uint8_t SST_initQueueElem(Queue *q, uint8_t size, uint8_t elemSize) {
   Semaphore sem;
+  uint8_t *data = (uint8_t*) SST_memAlloc((uint16_t)(size*elemSize));
+  if (data == NULL) {
+    return 0;
+  }
   SST_initSemaphore(&sem);
   SST_INT_LOCK();
   q->sem = sem;
-  q->data = (uint8_t*) os_malloc(sizeof(uint8_t)*size);
+  q->data = data;
   q->head = 0;
   q->tail = 0;
   q->nelem = 0;
   q->size = size;
+  q->elemSize = elemSize;
+  q->mask = ((size & (size - 1)) == 0) ? (uint8_t)(size - 1) : 0;
+  SST_INT_UNLOCK();
+  return 1;
+}
+
+uint8_t SST_initQueue(Queue *q, uint8_t size) {
+  return SST_initQueueElem(q, size, (uint8_t)sizeof(uint8_t));
+}
+
+/*  NOTE: queueWrap_(q, i) returns the index i (< 2*size) wrapped into the
+*  queue buffer.
+*/
+static inline uint8_t queueWrap_(Queue const *q, uint16_t i) {
+  if (q->mask != 0) {
+    return (uint8_t)(i & q->mask);
+  }
+  return (uint8_t)((i >= q->size) ? (i - q->size) : i);
+}
+
+void SST_freeQueue(Queue *q) {
+  uint8_t *data = q->data;
+  SST_INT_LOCK();
+  q->data = NULL;
+  q->size = 0;
+  q->nelem = 0;
   SST_INT_UNLOCK();
+  if (data != NULL) {
+    SST_memFree(data);
+  }
 }
 
 uint8_t SST_enqueue(Queue *q, uint8_t data) {
@@ -328,14 +908,14 @@ uint8_t SST_enqueue(Queue *q, uint8_t data) {
   SST_INT_LOCK();
   if (w) {	// if access is granted to the queue, then
     q->data[(int) q->head] = data;	// write data to it
-    q->head = (q->head + 1) % q->size;
+    q->head = queueWrap_(q, (uint16_t)(q->head + 1));
     q->nelem++;
     SST_INT_UNLOCK();
     SST_signal(&(q->sem));	// release lock on queue (lock and unlock INTs)
   }
 } else {  // if there's no more space in the queue, the task will be "suspended"
 SST_INT_LOCK();
-os_printf("DEBUG: NO MORE SPACE AVAILABLE!\n");
+SST_LOG_(SST_LOG_Q_FULL, SST_currPrio_, 0);
 // REVIEW: SST_enqueue - Add function addTaskSemQueue
 addTaskSemQueue(&(q->sem));
 /* CHANGED: SST_enqueue - Adding to semaphore's queue
@@ -355,14 +935,14 @@ uint8_t SST_dequeue(Queue *q, uint8_t *data) {
     SST_INT_LOCK();
     if (w) {	// if access is to the queue, then
       *data = q->data[(int) q->tail];	// read data from it
-      q->tail = (q->tail + 1) % q->size;
+      q->tail = queueWrap_(q, (uint16_t)(q->tail + 1));
       q->nelem--;
       SST_INT_UNLOCK();
       SST_signal(&(q->sem));	// release lock on queue (lock and unlock INTs)
     }
   } else {  // there is no data available, so the task will be "suspended"
   SST_INT_LOCK();
-  os_printf("DEBUG: NO DATA AVAILABLE!\n");
+  SST_LOG_(SST_LOG_Q_EMPTY, SST_currPrio_, 0);
   // REVIEW: SST_dequeue - Add function addTaskSemQueue
   addTaskSemQueue(&(q->sem));
   /* CHANGED: SST_dequeue - Adding to semaphore's queue
@@ -374,3 +954,71 @@ uint8_t SST_dequeue(Queue *q, uint8_t *data) {
 }
 return w;
 }
+
+/*  NOTE: SST_enqueueN(q, elems, n) copies up to n elements into the queue
+*  with at most two memcpy segments (before and after the wrap) under a
+*  single interrupt lock, and returns the number of elements written. If
+*  the queue is full nothing is written and the task is "suspended" on the
+*  queue like in SST_enqueue(). A task waiting for the queue is signaled
+*  once per call.
+*/
+uint8_t SST_enqueueN(Queue *q, void const *elems, uint8_t n) {
+  uint8_t const *src = (uint8_t const *)elems;
+  uint8_t first;
+  SST_INT_LOCK();
+  if (n > (uint8_t)(q->size - q->nelem)) {
+    n = (uint8_t)(q->size - q->nelem);        // only as much as fits
+  }
+  if (n == 0) {  // no space at all, the task will be "suspended"
+    addTaskSemQueue(&(q->sem));
+    SST_INT_UNLOCK();
+    return 0;
+  }
+  first = (uint8_t)(q->size - q->head);       // room before the wrap
+  if (first > n) {
+    first = n;
+  }
+  os_memcpy(&q->data[(uint16_t)q->head * q->elemSize], src,
+            (uint16_t)first * q->elemSize);
+  if (n > first) {
+    os_memcpy(q->data, src + (uint16_t)first * q->elemSize,
+              (uint16_t)(n - first) * q->elemSize);
+  }
+  q->head = queueWrap_(q, (uint16_t)(q->head + n));
+  q->nelem = (uint8_t)(q->nelem + n);
+  semWake_(&(q->sem));  // call the task waiting on this queue
+  SST_INT_UNLOCK();
+  return n;
+}
+
+/*  NOTE: SST_dequeueN(q, elems, n) is the counterpart of SST_enqueueN():
+*  it copies up to n elements out of the queue and returns how many.
+*/
+uint8_t SST_dequeueN(Queue *q, void *elems, uint8_t n) {
+  uint8_t *dst = (uint8_t *)elems;
+  uint8_t first;
+  SST_INT_LOCK();
+  if (n > q->nelem) {
+    n = q->nelem;
+  }
+  if (n == 0) {  // there is no data available, so the task will be "suspended"
+    addTaskSemQueue(&(q->sem));
+    SST_INT_UNLOCK();
+    return 0;
+  }
+  first = (uint8_t)(q->size - q->tail);
+  if (first > n) {
+    first = n;
+  }
+  os_memcpy(dst, &q->data[(uint16_t)q->tail * q->elemSize],
+            (uint16_t)first * q->elemSize);
+  if (n > first) {
+    os_memcpy(dst + (uint16_t)first * q->elemSize, q->data,
+              (uint16_t)(n - first) * q->elemSize);
+  }
+  q->tail = queueWrap_(q, (uint16_t)(q->tail + n));
+  q->nelem = (uint8_t)(q->nelem - n);
+  semWake_(&(q->sem));
+  SST_INT_UNLOCK();
+  return n;
+}
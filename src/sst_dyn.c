@@ -0,0 +1,85 @@
+/*****************************************************************************
+* SST dynamic events and event pools
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+
+#ifdef SST_DYN_POOLS
+
+/* Local-scope objects -----------------------------------------------------*/
+static SSTMemPool l_pool[SST_DYN_POOLS];
+static uint8_t l_nPools;
+
+/*..........................................................................*/
+/* NOTE: SST_dynPoolInit() must be called for the pools in ascending order
+ * of the block size, before the events are used. SST_dynNew() takes the
+ * first pool whose blocks are big enough. Returns 0 when SST_DYN_POOLS
+ * pools are already registered.
+ */
+uint8_t SST_dynPoolInit(void *storage, uint16_t storageSize,
+                        uint16_t blockSize)
+{
+    if (l_nPools >= (uint8_t)SST_DYN_POOLS) {
+        return (uint8_t)0;
+    }
+    SST_memPoolInit(&l_pool[l_nPools], storage, storageSize, blockSize);
+    ++l_nPools;
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+SSTDynEvt *SST_dynNew(uint16_t size) {
+    uint8_t id = (uint8_t)0;
+    SSTDynEvt *e = (SSTDynEvt *)0;
+    while ((id < l_nPools) && (size > l_pool[id].blockSize__)) {
+        ++id;
+    }
+    if (id < l_nPools) {
+        e = (SSTDynEvt *)SST_memGet(&l_pool[id]);
+        if (e != (SSTDynEvt *)0) {
+            e->poolId__ = (uint8_t)(id + 1U);
+            e->refCtr__ = (uint8_t)0;
+        }
+    }
+    return e;                    /* NULL when the matching pool is empty */
+}
+/*..........................................................................*/
+/* NOTE: SST_dynGc_() drops one reference and recycles the block when it
+ * was the last one (or when the event was never posted). Interrupts must
+ * be LOCKED.
+ */
+void SST_dynGc_(SSTDynEvt *e) {
+    if (e->refCtr__ > (uint8_t)1) {
+        --e->refCtr__;
+    }
+    else {
+        SST_memPut_(&l_pool[e->poolId__ - 1U], e);
+    }
+}
+/*..........................................................................*/
+void SST_dynGc(SSTDynEvt *e) {
+    SST_INT_LOCK();
+    SST_dynGc_(e);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+uint16_t SST_dynPoolUsed(uint8_t poolId) {
+    SSTMemPool const *pool = &l_pool[poolId - 1U];
+    return (uint16_t)(pool->nTot__ - pool->nFree__);
+}
+/*..........................................................................*/
+uint16_t SST_dynPoolMaxUsed(uint8_t poolId) {            /* high-water mark */
+    SSTMemPool const *pool = &l_pool[poolId - 1U];
+    return (uint16_t)(pool->nTot__ - pool->nMin__);
+}
+/*..........................................................................*/
+SSTMemPool const *SST_dynPool(uint8_t poolId) {  /* for the fail counter */
+    return &l_pool[poolId - 1U];
+}
+
+#endif                                                     /* SST_DYN_POOLS */
@@ -0,0 +1,231 @@
+/*****************************************************************************
+* SST table-driven hierarchical state machines
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_hsm.h"
+
+/*..........................................................................*/
+static uint8_t isSuper_(SSTHsmState const *st, uint8_t a, uint8_t s) {
+    for (s = st[s].super; s != SST_HSM_NONE; s = st[s].super) {
+        if (s == a) {
+            return (uint8_t)1;                   /* a contains s */
+        }
+    }
+    return (uint8_t)0;
+}
+/*..........................................................................*/
+/* NOTE: lca_() returns the state that a transition stays inside of, so the
+ * states below it are exited and entered (see the note in sst_hsm.h).
+ */
+static uint8_t lca_(SSTHsmState const *st, uint8_t src, uint8_t tgt) {
+    uint8_t s;
+    if (src == tgt) {
+        return st[src].super;                          /* self-transition */
+    }
+    if (isSuper_(st, tgt, src)) {
+        return st[tgt].super;                     /* up to a superstate */
+    }
+    if (isSuper_(st, src, tgt)) {
+        return src;                                /* down to a substate */
+    }
+    for (s = st[src].super; s != SST_HSM_NONE; s = st[s].super) {
+        if (isSuper_(st, s, tgt)) {
+            break;
+        }
+    }
+    return s;
+}
+/*..........................................................................*/
+static uint8_t find_(SSTHsmDef const *def, uint8_t s, SSTSignal sig) {
+    uint8_t t;
+    for (; s != SST_HSM_NONE; s = def->states[s].super) {
+        for (t = (uint8_t)0; t < def->nTrans; ++t) {
+            if ((def->trans[t].source == s) && (def->trans[t].sig == sig)) {
+                return t;              /* the innermost handler wins */
+            }
+        }
+    }
+    return SST_HSM_NONE;
+}
+/*..........................................................................*/
+/* NOTE: build_() resolves the transition 'tran' taken in the leaf state
+ * 'leaf' (tran NONE is the start) into 'c' and writes the states to exit
+ * and then to enter to 'path', when not NULL. Returns the path length.
+ */
+static uint8_t build_(SSTHsmDef const *def, uint8_t leaf, uint8_t tran,
+                      SSTHsmCell *c, uint8_t *path)
+{
+    SSTHsmState const *st = def->states;
+    uint8_t target = def->init;
+    uint8_t lca = SST_HSM_NONE;
+    uint8_t n = (uint8_t)0;
+    uint8_t k;
+    uint8_t s;
+
+    c->tran = tran;
+    if (tran != SST_HSM_NONE) {
+        target = def->trans[tran].target;
+        if (target == SST_HSM_NONE) {               /* internal transition */
+            c->nExit = (uint8_t)0;
+            c->nEntry = (uint8_t)0;
+            c->leaf = leaf;
+            return (uint8_t)0;
+        }
+        lca = lca_(st, def->trans[tran].source, target);
+        for (s = leaf; s != lca; s = st[s].super) {      /* exit up to lca */
+            if (path != (uint8_t *)0) {
+                path[n] = s;
+            }
+            ++n;
+        }
+    }
+    c->nExit = n;
+    for (s = target; s != lca; s = st[s].super) {       /* enter down ... */
+        ++n;
+    }
+    k = n;
+    for (s = target; s != lca; s = st[s].super) {  /* ... written backwards */
+        --k;
+        if (path != (uint8_t *)0) {
+            path[k] = s;
+        }
+    }
+    for (s = target; st[s].init != SST_HSM_NONE; ++n) {  /* initial trans. */
+        s = st[s].init;
+        if (path != (uint8_t *)0) {
+            path[n] = s;
+        }
+    }
+    c->nEntry = (uint8_t)(n - c->nExit);
+    c->leaf = s;
+    return n;
+}
+/*..........................................................................*/
+/* NOTE: resolve_() fills the cells, the lookup table and the paths, or only
+ * counts them when the pointers are NULL. Returns the number of cells, or
+ * 0 when the lookup table cannot index them all.
+ */
+static uint16_t resolve_(SSTHsmDef const *def, SSTHsmCell *cell,
+                         uint8_t *lut, uint8_t *path, uint16_t *pathLen)
+{
+    SSTHsmCell c;
+    uint16_t nCells = (uint16_t)1;
+    uint16_t len;
+    SSTSignal sig;
+    uint8_t s;
+
+    c.path = (uint16_t)0;
+    len = build_(def, SST_HSM_NONE, SST_HSM_NONE, &c, path);  /* the start */
+    if (cell != (SSTHsmCell *)0) {
+        cell[0] = c;
+    }
+    for (s = (uint8_t)0; s < def->nStates; ++s) {
+        for (sig = (SSTSignal)0; sig < def->nSigs; ++sig) {
+            uint8_t t = SST_HSM_NONE;
+            uint8_t idx = (uint8_t)0;                       /* unhandled */
+            if (def->states[s].init == SST_HSM_NONE) {   /* only leaves */
+                t = find_(def, s, sig);
+            }
+            if (t != SST_HSM_NONE) {
+                if (nCells == (uint16_t)SST_HSM_NONE) {
+                    return (uint16_t)0;                 /* too many cells */
+                }
+                c.path = len;
+                len = (uint16_t)(len + build_(def, s, t, &c,
+                                    (path != (uint8_t *)0) ? &path[len]
+                                                           : (uint8_t *)0));
+                if (cell != (SSTHsmCell *)0) {
+                    cell[nCells] = c;
+                }
+                idx = (uint8_t)nCells++;
+            }
+            if (lut != (uint8_t *)0) {
+                lut[(uint16_t)s * def->nSigs + sig] = idx;
+            }
+        }
+    }
+    *pathLen = len;
+    return nCells;
+}
+/*..........................................................................*/
+uint16_t SST_hsmWorkSize(SSTHsmDef const *def) {
+    uint16_t pathLen;
+    uint16_t nCells = resolve_(def, (SSTHsmCell *)0, (uint8_t *)0,
+                               (uint8_t *)0, &pathLen);
+    if (nCells == (uint16_t)0) {
+        return (uint16_t)0;
+    }
+    return (uint16_t)(nCells * sizeof(SSTHsmCell)
+                      + (uint16_t)def->nStates * def->nSigs + pathLen);
+}
+/*..........................................................................*/
+/* NOTE: 'work' must be aligned for uint16_t and hold SST_hsmWorkSize()
+ * bytes; the machine then uses no other RAM. Returns 0 when it is too
+ * small or the machine has more than 254 handled state/signal pairs.
+ */
+uint8_t SST_hsmInit(SSTHsm *me, SSTHsmDef const *def, void *ctx,
+                    void *work, uint16_t workSize)
+{
+    uint16_t need = SST_hsmWorkSize(def);
+    uint16_t pathLen;
+    uint16_t nCells;
+    if ((need == (uint16_t)0) || (need > workSize)) {
+        return (uint8_t)0;
+    }
+    nCells = resolve_(def, (SSTHsmCell *)0, (uint8_t *)0, (uint8_t *)0,
+                      &pathLen);
+    me->def__ = def;
+    me->ctx__ = ctx;
+    me->cell__ = (SSTHsmCell *)work;
+    me->lut__ = (uint8_t *)&me->cell__[nCells];
+    me->path__ = &me->lut__[(uint16_t)def->nStates * def->nSigs];
+    me->state__ = SST_HSM_NONE;
+    (void)resolve_(def, me->cell__, me->lut__, me->path__, &pathLen);
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+void SST_hsmDispatch(SSTHsm *me, SSTEvent const *e) {
+    SSTHsmDef const *def = me->def__;
+    SSTHsmCell const *c = &me->cell__[0];           /* the initial event */
+    uint8_t const *p;
+    uint8_t n;
+
+    if (me->state__ != SST_HSM_NONE) {
+        uint8_t idx;
+        if (e->sig >= def->nSigs) {
+            return;                                  /* no such signal */
+        }
+        idx = me->lut__[(uint16_t)me->state__ * def->nSigs + e->sig];
+        if (idx == (uint8_t)0) {
+            return;                                /* unhandled, ignored */
+        }
+        c = &me->cell__[idx];
+    }
+    p = &me->path__[c->path];
+    for (n = c->nExit; n != (uint8_t)0; --n, ++p) {
+        SSTHsmAction exit = def->states[*p].exit;
+        if (exit != (SSTHsmAction)0) {
+            (*exit)(me->ctx__, e);
+        }
+    }
+    if (c->tran != SST_HSM_NONE) {
+        SSTHsmAction act = def->trans[c->tran].action;
+        if (act != (SSTHsmAction)0) {
+            (*act)(me->ctx__, e);
+        }
+    }
+    for (n = c->nEntry; n != (uint8_t)0; --n, ++p) {
+        SSTHsmAction entry = def->states[*p].entry;
+        if (entry != (SSTHsmAction)0) {
+            (*entry)(me->ctx__, e);
+        }
+    }
+    me->state__ = c->leaf;
+}
@@ -0,0 +1,114 @@
+/*****************************************************************************
+* SST deferred logging
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_ring.h"
+
+#if SST_LOG_LEVEL > SST_LOG_OFF
+
+#ifndef SST_LOG_LEN
+#define SST_LOG_LEN 32U                    /* records, a power of two */
+#endif
+
+/* Local-scope objects -----------------------------------------------------*/
+#define SST_LOG_FMT_(id_, lvl_, fmt_)  fmt_,
+static char const * const l_fmt[SST_LOG_N_MSGS] = {
+    SST_LOG_MSGS(SST_LOG_FMT_)
+    SST_LOG_APP_MSGS(SST_LOG_FMT_)
+};
+static SSTLogRec l_buf[SST_LOG_LEN];
+static SSTRing l_ring = {                    /* as SST_ringInit() sets it */
+    (uint8_t *)l_buf, (uint16_t)(SST_LOG_LEN - 1U),
+    (uint8_t)sizeof(SSTLogRec), (uint8_t)0, (SSTSignal)0,
+    (uint16_t)0, (uint16_t)0
+};
+static uint16_t l_dropped;              /* records lost on a full buffer */
+static uint16_t l_reported;               /* ...of which already drained */
+
+/*..........................................................................*/
+/* NOTE: SST_logPut_() is the producer side of the ring. The producers are
+ * serialized by the interrupt lock, which the kernel call sites hold anyway,
+ * and the drain side takes no lock at all.
+ */
+void SST_logPut_(uint8_t id, uint16_t a, uint32_t b) {
+    SSTLogRec r;
+    r.id = id;
+    r.reserved = (uint8_t)0;
+    r.a = a;
+    r.b = b;
+    if (!SST_ringPush(&l_ring, &r)) {
+        ++l_dropped;                         /* never block on a full log */
+    }
+}
+/*..........................................................................*/
+void SST_logPut(uint8_t id, uint16_t a, uint32_t b) {
+    SST_INT_LOCK();
+    SST_logPut_(id, a, b);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+/* NOTE: lostRec_() makes the record reporting the records dropped since the
+ * last drain, if any.
+ */
+static uint8_t lostRec_(SSTLogRec *r) {
+    uint16_t lost = (uint16_t)(l_dropped - l_reported);  /* racy read, ok */
+    if (lost == (uint16_t)0) {
+        return (uint8_t)0;
+    }
+    l_reported = (uint16_t)(l_reported + lost);
+    r->id = (uint8_t)SST_LOG_DROPPED;
+    r->reserved = (uint8_t)0;
+    r->a = lost;
+    r->b = (uint32_t)0;
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+/* NOTE: SST_logDrain() formats up to 'max' records with os_printf() and
+ * returns how many. Call it from one task only, at the lowest priority, so
+ * the slow output never delays the other tasks.
+ */
+uint8_t SST_logDrain(uint8_t max) {
+    SSTLogRec r;
+    uint8_t n = (uint8_t)0;
+    if (lostRec_(&r)) {
+        os_printf(l_fmt[r.id], (unsigned)r.a);
+        os_printf("\n");
+    }
+    while ((n < max) && SST_ringPop(&l_ring, &r)) {
+        if (r.id < (uint8_t)SST_LOG_N_MSGS) {
+            os_printf(l_fmt[r.id], (unsigned)r.a, (unsigned)r.b);
+            os_printf("\n");
+        }
+        ++n;
+    }
+    return n;
+}
+/*..........................................................................*/
+/* NOTE: SST_logDrainRaw() writes up to 'max' records unformatted, 8 bytes
+ * each and little-endian, for tools/sst_log.py on the host.
+ */
+uint8_t SST_logDrainRaw(SSTLogOut out, uint8_t max) {
+    SSTLogRec r;
+    uint8_t n = (uint8_t)0;
+    if (lostRec_(&r)) {
+        (*out)(&r, (uint16_t)sizeof(r));
+    }
+    while ((n < max) && SST_ringPop(&l_ring, &r)) {
+        (*out)(&r, (uint16_t)sizeof(r));
+        ++n;
+    }
+    return n;
+}
+/*..........................................................................*/
+uint16_t SST_logDropped(void) {
+    return l_dropped;
+}
+
+#endif                                                 /* SST_LOG_LEVEL */
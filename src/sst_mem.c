@@ -0,0 +1,168 @@
+/*****************************************************************************
+* SST fixed-block memory pools
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+
+typedef struct FreeBlockTag FreeBlock;
+struct FreeBlockTag {
+    FreeBlock *next;
+};
+
+/* Local-scope objects -----------------------------------------------------*/
+static SSTMemPool l_partition[SST_MEM_POOLS];      /* for kernel objects */
+static uint8_t l_nPartitions;
+
+/*..........................................................................*/
+/* NOTE: SST_memPoolInit() carves the blocks upwards from the first
+ * pointer-aligned byte of the storage, with the block size rounded up to
+ * the same alignment, so every block is aligned whatever the storage size;
+ * the tail too short for a block is left unused.
+ */
+void SST_memPoolInit(SSTMemPool *mp, void *storage, uint16_t storageSize,
+                     uint16_t blockSize)
+{
+    uint8_t *block = (uint8_t *)storage;
+    uint16_t skip = (uint16_t)((0U - (uintptr_t)block)
+                               & (sizeof(FreeBlock) - 1U));
+    uint16_t n;
+    uint16_t i;
+
+    if (blockSize < (uint16_t)sizeof(FreeBlock)) {
+        blockSize = (uint16_t)sizeof(FreeBlock);
+    }
+                          /* round up to keep every block pointer-aligned */
+    blockSize = (uint16_t)((blockSize + sizeof(FreeBlock) - 1U)
+                           & ~(sizeof(FreeBlock) - 1U));
+    if (storageSize < skip) {
+        skip = storageSize;
+    }
+    block += skip;
+    n = (uint16_t)((uint16_t)(storageSize - skip) / blockSize);
+    mp->free__ = (void *)0;
+    for (i = n; i != (uint16_t)0; --i) {  /* thread the blocks, first on top */
+        FreeBlock *fb = (FreeBlock *)(block + (uint32_t)(i - 1U) * blockSize);
+        fb->next = (FreeBlock *)mp->free__;
+        mp->free__ = fb;
+    }
+    mp->start__ = block;
+    mp->end__ = block + (uint32_t)n * blockSize;
+    mp->blockSize__ = blockSize;
+    mp->nTot__  = n;
+    mp->nFree__ = n;
+    mp->nMin__  = n;
+    mp->nFail__ = (uint16_t)0;
+}
+/*..........................................................................*/
+void *SST_memGet_(SSTMemPool *mp) {
+    FreeBlock *fb = (FreeBlock *)mp->free__;
+    if (fb != (FreeBlock *)0) {
+        mp->free__ = fb->next;
+        if ((--mp->nFree__) < mp->nMin__) {
+            mp->nMin__ = mp->nFree__;
+        }
+    }
+    else {
+        ++mp->nFail__;                              /* the pool ran empty */
+    }
+    return fb;
+}
+/*..........................................................................*/
+void SST_memPut_(SSTMemPool *mp, void *block) {
+    FreeBlock *fb = (FreeBlock *)block;
+    fb->next = (FreeBlock *)mp->free__;
+    mp->free__ = fb;
+    ++mp->nFree__;
+}
+/*..........................................................................*/
+void *SST_memGet(SSTMemPool *mp) {
+    void *block;
+    SST_INT_LOCK();
+    block = SST_memGet_(mp);
+    SST_INT_UNLOCK();
+    return block;
+}
+/*..........................................................................*/
+void SST_memPut(SSTMemPool *mp, void *block) {
+    SST_INT_LOCK();
+    SST_memPut_(mp, block);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+uint16_t SST_memPoolFree(SSTMemPool const *mp) {
+    return mp->nFree__;
+}
+/*..........................................................................*/
+uint16_t SST_memPoolMinFree(SSTMemPool const *mp) {
+    return mp->nMin__;
+}
+/*..........................................................................*/
+uint16_t SST_memPoolFails(SSTMemPool const *mp) {
+    return mp->nFail__;
+}
+
+/*..........................................................................*/
+/* NOTE: SST_memInit() returns 0 when SST_MEM_POOLS partitions are already
+ * registered.
+ */
+uint8_t SST_memInit(void *storage, uint16_t storageSize, uint16_t blockSize) {
+    if (l_nPartitions >= (uint8_t)SST_MEM_POOLS) {
+        return (uint8_t)0;
+    }
+    SST_memPoolInit(&l_partition[l_nPartitions], storage, storageSize,
+                    blockSize);
+    ++l_nPartitions;
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+/* NOTE: SST_memAlloc() takes a block from the smallest partition that fits
+ * and falls back to the larger ones when it is empty. It returns NULL when
+ * no partition can satisfy the request, and only then counts a failure,
+ * on the smallest partition that fits.
+ */
+void *SST_memAlloc(uint16_t size) {
+    void *block = (void *)0;
+    SSTMemPool *fits = (SSTMemPool *)0;
+    uint8_t id;
+    SST_INT_LOCK();
+    for (id = (uint8_t)0; id < l_nPartitions; ++id) {
+        SSTMemPool *mp = &l_partition[id];
+        if (size <= mp->blockSize__) {
+            if (fits == (SSTMemPool *)0) {
+                fits = mp;
+            }
+            if (mp->free__ != (void *)0) {
+                block = SST_memGet_(mp);
+                break;
+            }
+        }
+    }
+    if ((block == (void *)0) && (fits != (SSTMemPool *)0)) {
+        ++fits->nFail__;
+    }
+    SST_INT_UNLOCK();
+    return block;
+}
+/*..........................................................................*/
+void SST_memFree(void *block) {
+    uint8_t id;
+    for (id = (uint8_t)0; id < l_nPartitions; ++id) {
+        SSTMemPool *mp = &l_partition[id];
+        if (((uint8_t *)block >= mp->start__)
+            && ((uint8_t *)block < mp->end__))
+        {
+            SST_memPut(mp, block);
+            break;
+        }
+    }
+}
+/*..........................................................................*/
+SSTMemPool const *SST_memPartition(uint8_t id) {
+    return &l_partition[id];
+}
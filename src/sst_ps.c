@@ -0,0 +1,52 @@
+/*****************************************************************************
+* SST publish-subscribe signal routing
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: Every signal below SST_MAX_SIG has the set of the priorities of its
+  subscribers. SST_publish() hands that set to SST_postMask(), so the event
+  reaches all the subscribers under one critical section, the newly ready
+  ones enter the ready set in one update and the scheduler then runs them
+  in priority order. Producers no longer need to know the consumers.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#include "sst_port.h"
+
+#if SST_MAX_KERNELS > 1
+#define SUBSCR_(sig_)   (SST_kernel_->subscr__[(sig_)])
+#else
+/* Local-scope objects -----------------------------------------------------*/
+static SSTPrioSet l_subscrList[SST_MAX_SIG];       /* all clear at startup */
+#define SUBSCR_(sig_)   (l_subscrList[(sig_)])
+#endif
+
+/*..........................................................................*/
+void SST_subscribe(uint8_t prio, SSTSignal sig) {
+    SST_INT_LOCK();
+    SST_prioSetInsert(&SUBSCR_(sig), prio);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+void SST_unsubscribe(uint8_t prio, SSTSignal sig) {
+    SST_INT_LOCK();
+    SST_prioSetRemove(&SUBSCR_(sig), prio);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+/* NOTE: SST_publish() returns the number of subscribers that got the event;
+ * a subscriber with a full queue misses it, like with SST_post().
+ */
+uint8_t SST_publish(SSTSignal sig, SSTParam par) {
+    SSTPrioSet subscr;
+    SST_INT_LOCK();
+    subscr = SUBSCR_(sig);                 /* a consistent copy of the list */
+    SST_INT_UNLOCK();
+    return SST_postMask(&subscr, sig, par, (SSTPrioSet *)0);
+}
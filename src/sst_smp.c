@@ -0,0 +1,151 @@
+/*****************************************************************************
+* SST kernel contexts and posting between kernels
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: The inbox of a kernel is a bounded multi-producer, single-consumer
+  queue without locks. Every slot carries a sequence number that tells
+  whose turn it is: a poster claims the slot at inboxHead__ with a
+  compare-and-swap, fills it and publishes it by storing the next sequence,
+  and the owning kernel takes the slots in order and hands each back for
+  the next lap. Posters never wait for each other or for the owner, and a
+  full inbox fails the post like a full event queue. The atomics are the
+  GCC/Clang __atomic builtins, which a multi-core port needs anyway.
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#include "sst_port.h"
+
+#if SST_MAX_KERNELS > 1
+
+#define DRAIN_BATCH  16U             /* inbox events per scheduling pass */
+
+/*..........................................................................*/
+void SST_kernelInit(SSTKernel *k, uint8_t id) {
+    uint8_t *b = (uint8_t *)k;
+    uint32_t n;
+    for (n = (uint32_t)sizeof(*k); n != 0U; --n) {
+        *b++ = (uint8_t)0;
+    }
+    k->currPrio__ = (uint8_t)0xFF;  /* like SST_kernel0_ before SST_run() */
+#ifdef SST_EVT_POOL
+    k->evtFree__ = SST_EVT_NIL;
+#endif
+    k->id__ = id;
+}
+/*..........................................................................*/
+void SST_kernelBind(SSTKernel *k) {
+    SST_kernel_ = k;
+}
+/*..........................................................................*/
+/* NOTE: the capacity must be a power of two; the inbox must be initialized
+ * before any other kernel posts to 'k'.
+ */
+void SST_inboxInit(SSTKernel *k, SSTInboxMsg *storage, uint16_t capacity) {
+    uint32_t i;
+    for (i = 0U; i < capacity; ++i) {
+        storage[i].seq__ = i;
+    }
+    k->inbox__ = storage;
+    k->inboxMask__ = (uint32_t)capacity - 1U;
+    k->inboxTail__ = 0U;
+    k->inboxDrops__ = 0U;
+    __atomic_store_n(&k->inboxHead__, 0U, __ATOMIC_RELEASE);
+}
+/*..........................................................................*/
+/* NOTE: SST_postTo() posts to the task 'prio' of the kernel 'k' from any
+ * thread, task or ISR. A post to the caller's own kernel is SST_post().
+ * Returns 0 when the inbox is full; the event can still be lost later on
+ * a full event queue of the receiver, as counted by SST_overflowDrops().
+ */
+uint8_t SST_postTo(SSTKernel *k, uint8_t prio, SSTSignal sig, SSTParam par) {
+    SSTInboxMsg *m;
+    uint32_t pos;
+    if (k == SST_kernel_) {
+        return SST_post(prio, sig, par);
+    }
+    pos = __atomic_load_n(&k->inboxHead__, __ATOMIC_RELAXED);
+    for (;;) {
+        int32_t dif;
+        m = &k->inbox__[pos & k->inboxMask__];
+        dif = (int32_t)(__atomic_load_n(&m->seq__, __ATOMIC_ACQUIRE) - pos);
+        if (dif == 0) {                            /* the slot is free... */
+            if (__atomic_compare_exchange_n(&k->inboxHead__, &pos, pos + 1U,
+                                            1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;                                 /* ...and now ours */
+            }
+        }
+        else if (dif < 0) {                   /* a lap behind, inbox full */
+            __atomic_fetch_add(&k->inboxDrops__, 1U, __ATOMIC_RELAXED);
+            return (uint8_t)0;
+        }
+        else {                                /* taken, try the next one */
+            pos = __atomic_load_n(&k->inboxHead__, __ATOMIC_RELAXED);
+        }
+    }
+    m->prio = prio;
+    m->sig = sig;
+    m->par = par;
+    __atomic_store_n(&m->seq__, pos + 1U, __ATOMIC_RELEASE);   /* publish */
+    SST_onInbox(k);
+    return (uint8_t)1;
+}
+/*..........................................................................*/
+/* NOTE: SST_inboxDrain() moves the events of the calling kernel's inbox to
+ * the queues of its tasks, DRAIN_BATCH at a time with SST_postBatch(), so
+ * the receivers run in priority order once per batch. The port calls it
+ * from the kernel's idle loop or from the ISR that SST_onInbox() raises.
+ * Returns the number of events taken.
+ */
+uint16_t SST_inboxDrain(void) {
+    SSTKernel *k = SST_kernel_;
+    SSTPost posts[DRAIN_BATCH];
+    uint16_t total = (uint16_t)0;
+    uint8_t n;
+    if (k->inbox__ == (SSTInboxMsg *)0) {
+        return (uint16_t)0;
+    }
+    do {
+        for (n = (uint8_t)0; n < (uint8_t)DRAIN_BATCH; ++n) {
+            uint32_t tail = k->inboxTail__;
+            SSTInboxMsg *m = &k->inbox__[tail & k->inboxMask__];
+            if (__atomic_load_n(&m->seq__, __ATOMIC_ACQUIRE) != tail + 1U) {
+                break;                                           /* empty */
+            }
+            posts[n].prio = m->prio;
+            posts[n].sig = m->sig;
+            posts[n].par = m->par;
+            __atomic_store_n(&m->seq__, tail + k->inboxMask__ + 1U,
+                             __ATOMIC_RELEASE);      /* free for next lap */
+            k->inboxTail__ = tail + 1U;
+        }
+        if (n != (uint8_t)0) {
+            (void)SST_postBatch(posts, n);
+            total = (uint16_t)(total + n);
+        }
+    } while (n == (uint8_t)DRAIN_BATCH);
+    return total;
+}
+/*..........................................................................*/
+/* NOTE: SST_inboxPending() may only be called by the kernel 'k' itself. */
+uint8_t SST_inboxPending(SSTKernel const *k) {
+    uint32_t tail = k->inboxTail__;
+    if (k->inbox__ == (SSTInboxMsg *)0) {
+        return (uint8_t)0;
+    }
+    return (uint8_t)(__atomic_load_n(&k->inbox__[tail & k->inboxMask__].seq__,
+                                     __ATOMIC_ACQUIRE) == tail + 1U);
+}
+/*..........................................................................*/
+uint32_t SST_inboxDrops(SSTKernel const *k) {    /* posts on a full inbox */
+    return __atomic_load_n(&k->inboxDrops__, __ATOMIC_RELAXED);
+}
+
+#endif                                             /* SST_MAX_KERNELS > 1 */
@@ -0,0 +1,86 @@
+/*****************************************************************************
+* SST single-stack profiling
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+
+#ifdef SST_STACK_PROF
+
+#define PAINT       ((uint8_t)0xA5)
+#define PAINT_GAP   64U       /* bytes left unpainted below the caller's SP */
+
+/* Public-scope objects ----------------------------------------------------*/
+SSTStackProf SST_stackProf_;
+uint8_t *SST_stackBase_;
+uint8_t SST_stackNest_;
+uint8_t SST_stackChain_[SST_MAX_PRIO];
+
+/* Local-scope objects -----------------------------------------------------*/
+static uint8_t *l_paintLo;
+static uint8_t *l_paintHi;
+
+/*..........................................................................*/
+/* NOTE: SST_stackPaint() paints the stack from 'lo', its lowest address, up
+ * to a little below the caller's frame. Call it early, from the deepest
+ * point that is still unused, e.g. before SST_run().
+ */
+void SST_stackPaint(void *lo) {
+    uint8_t *p = (uint8_t *)lo;
+    l_paintLo = p;
+    l_paintHi = SST_STACK_SP() - PAINT_GAP;
+    while (p < l_paintHi) {
+        *p++ = PAINT;
+    }
+}
+/*..........................................................................*/
+/* NOTE: SST_stackHighWater() returns the bytes used below the painted top,
+ * or 0 when the stack was not painted.
+ */
+uint32_t SST_stackHighWater(void) {
+    uint8_t const *p = l_paintLo;
+    if (p == (uint8_t *)0) {
+        return 0U;
+    }
+    while ((p < l_paintHi) && (*p == PAINT)) {
+        ++p;
+    }
+    return (uint32_t)(l_paintHi - p);
+}
+/*..........................................................................*/
+/* NOTE: SST_stackReport() prints the profile with os_printf(), so call it
+ * from a task and not with interrupts locked.
+ */
+void SST_stackReport(void) {
+    SSTStackProf prof;
+    uint16_t p;
+    uint8_t i;
+    SST_INT_LOCK();
+    prof = SST_stackProf_;
+    SST_INT_UNLOCK();
+    os_printf("SST stack: peak %u bytes at dispatch, %u tasks nested max\n",
+              (unsigned)prof.peakDepth, (unsigned)prof.maxNest);
+    os_printf("  peak chain: idle");
+    for (i = (uint8_t)0; i < prof.peakLen; ++i) {
+        os_printf(" -> %u", (unsigned)prof.peakChain[i]);
+    }
+    os_printf("\n");
+    if (l_paintLo != (uint8_t *)0) {
+        os_printf("  high-water: %u of %u painted bytes\n",
+                  (unsigned)SST_stackHighWater(),
+                  (unsigned)(l_paintHi - l_paintLo));
+    }
+    for (p = 0U; p < (uint16_t)SST_MAX_PRIO; ++p) {
+        if (prof.maxDepth[p] != (uint16_t)0) {
+            os_printf("  prio %3u: %u bytes\n", (unsigned)(p + 1U),
+                      (unsigned)prof.maxDepth[p]);
+        }
+    }
+}
+
+#endif                                                    /* SST_STACK_PROF */
@@ -0,0 +1,88 @@
+/*****************************************************************************
+* SST runtime statistics
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+#include "sst_ring.h"                                  /* SST_MEM_BARRIER() */
+
+#ifdef SST_STATS
+
+#define STATS_TRIES 3U         /* lock-free copies before locking per task */
+
+/* Public-scope objects ----------------------------------------------------*/
+SSTStats SST_stats_;
+volatile uint32_t SST_statsSeq_;
+uint32_t SST_statsLast_;
+uint8_t SST_statsRunning_;
+uint8_t SST_statsIsrNest_;
+
+/*..........................................................................*/
+/* NOTE: SST_getStats() returns 1 when the snapshot is consistent as a whole.
+ * The time used by the caller up to the copy is included.
+ */
+uint8_t SST_getStats(SSTStats *st) {
+    uint8_t tries;
+    uint16_t p;
+
+    SST_INT_LOCK();
+    ++SST_statsSeq_;
+    SST_statsCharge_();                       /* bring the times up to now */
+    ++SST_statsSeq_;
+    SST_INT_UNLOCK();
+
+    for (tries = (uint8_t)0; tries < (uint8_t)STATS_TRIES; ++tries) {
+        uint32_t seq = SST_statsSeq_;
+        SST_MEM_BARRIER();
+        *st = SST_stats_;
+        SST_MEM_BARRIER();
+        if (seq == SST_statsSeq_) {
+            st->consistent = (uint8_t)1;
+            st->hz = (uint32_t)SST_CYCLES_HZ;
+            return (uint8_t)1;
+        }
+    }
+
+    SST_INT_LOCK();                     /* busy system, copy task by task */
+    st->idleTime = SST_stats_.idleTime;
+    st->isrTime = SST_stats_.isrTime;
+    SST_INT_UNLOCK();
+    for (p = 0U; p < (uint16_t)SST_MAX_PRIO; ++p) {
+        SST_INT_LOCK();
+        st->task[p] = SST_stats_.task[p];
+        SST_INT_UNLOCK();
+    }
+    st->consistent = (uint8_t)0;
+    st->hz = (uint32_t)SST_CYCLES_HZ;
+    return (uint8_t)0;
+}
+/*..........................................................................*/
+void SST_statsReset(void) {
+    uint16_t p;
+    SST_INT_LOCK();
+    ++SST_statsSeq_;
+    SST_statsLast_ = SST_CYCLES();
+    SST_stats_.idleTime = 0U;
+    SST_stats_.isrTime = 0U;
+    SST_INT_UNLOCK();
+    for (p = 0U; p < (uint16_t)SST_MAX_PRIO; ++p) {
+        SST_INT_LOCK();
+        SST_stats_.task[p].runTime = 0U;
+        SST_stats_.task[p].maxRun = 0U;
+        SST_stats_.task[p].dispatches = 0U;
+        SST_stats_.task[p].preemptions = 0U;
+        SST_stats_.task[p].postFails = (uint16_t)0;
+        SST_stats_.task[p].maxUsed = (uint8_t)0;
+        SST_INT_UNLOCK();
+    }
+    SST_INT_LOCK();
+    ++SST_statsSeq_;
+    SST_INT_UNLOCK();
+}
+
+#endif                                                         /* SST_STATS */
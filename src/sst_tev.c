@@ -0,0 +1,230 @@
+/*****************************************************************************
+* SST time events
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  NOTE: A time event posts its signal/parameter to a task priority after a
+  number of ticks, once or periodically. All time events are driven by one
+  tick ISR that calls SST_tick() between SST_ISR_ENTRY() and SST_ISR_EXIT().
+  The armed events are kept in a hashed timing wheel of SST_TEV_SLOTS slots:
+  an event due in 'ticks' goes to slot (cursor + ticks) % SST_TEV_SLOTS with
+  the number of full revolutions to wait. Every tick visits one slot only,
+  so the tick costs O(1) as long as the events are spread over the slots.
+  Arm, disarm and rearm are O(1) and can be called from tasks and ISRs.
+  In the tickless mode (SST_TICKLESS) the idle loop sleeps until the next
+  expiry instead of taking every tick, see SST_tickless().
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
+#include "sst_port.h"
+
+#define SLOT_DISARMED ((uint8_t)0xFF)
+#define DUE_END       (&l_dueEnd)        /* ends a due list, never NULL */
+
+/* Local-scope objects -----------------------------------------------------*/
+static SSTTimeEvt l_dueEnd;
+
+/*..........................................................................*/
+/* NOTE: link_()/unlink_() must be called with interrupts LOCKED. */
+static void link_(SSTTimeEvt *te, uint16_t ticks) {
+    SSTKernel *k = SST_kernel_;
+    uint8_t slot = (uint8_t)((k->cursor__ + ticks) & (SST_TEV_SLOTS - 1U));
+    te->rounds__ = (uint16_t)((uint16_t)(ticks - 1U) >> SST_TEV_SLOTS_LOG2);
+    te->slot__ = slot;
+    te->prev__ = (SSTTimeEvt *)0;
+    te->next__ = k->wheel__[slot];
+    if (te->next__ != (SSTTimeEvt *)0) {
+        te->next__->prev__ = te;
+    }
+    k->wheel__[slot] = te;
+}
+static void unlink_(SSTTimeEvt *te) {
+    if (te->prev__ != (SSTTimeEvt *)0) {
+        te->prev__->next__ = te->next__;
+    }
+    else {
+        SST_kernel_->wheel__[te->slot__] = te->next__;
+    }
+    if (te->next__ != (SSTTimeEvt *)0) {
+        te->next__->prev__ = te->prev__;
+    }
+    te->slot__ = SLOT_DISARMED;
+}
+
+/*..........................................................................*/
+void SST_timeEvtInit(SSTTimeEvt *te, uint8_t prio, SSTSignal sig,
+                     SSTParam par)
+{
+    te->next__ = (SSTTimeEvt *)0;
+    te->prev__ = (SSTTimeEvt *)0;
+    te->due__ = (SSTTimeEvt *)0;
+    te->rounds__ = (uint16_t)0;
+    te->interval__ = (uint16_t)0;
+    te->slot__ = SLOT_DISARMED;
+    te->prio__ = prio;
+    te->sig__ = sig;
+    te->par__ = par;
+}
+/*..........................................................................*/
+/* NOTE: SST_timeEvtArm() arms the event to expire in 'ticks' (>= 1) ticks
+ * and then every 'interval' ticks, or only once when 'interval' is 0.
+ * An armed event is re-armed.
+ */
+void SST_timeEvtArm(SSTTimeEvt *te, uint16_t ticks, uint16_t interval) {
+    if (ticks == (uint16_t)0) {
+        ticks = (uint16_t)1;
+    }
+    SST_INT_LOCK();
+    if (te->slot__ != SLOT_DISARMED) {
+        unlink_(te);
+    }
+    te->interval__ = interval;
+    link_(te, ticks);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+/* returns 1 if the event was armed and 0 if it had already expired */
+uint8_t SST_timeEvtDisarm(SSTTimeEvt *te) {
+    uint8_t wasArmed;
+    SST_INT_LOCK();
+    wasArmed = (uint8_t)(te->slot__ != SLOT_DISARMED);
+    if (wasArmed) {
+        unlink_(te);
+    }
+    SST_INT_UNLOCK();
+    return wasArmed;
+}
+/*..........................................................................*/
+/* NOTE: SST_timeEvtRearm() restarts the event to expire in 'ticks' ticks,
+ * keeping its interval, and returns 1 if it was still armed.
+ */
+uint8_t SST_timeEvtRearm(SSTTimeEvt *te, uint16_t ticks) {
+    uint8_t wasArmed;
+    if (ticks == (uint16_t)0) {
+        ticks = (uint16_t)1;
+    }
+    SST_INT_LOCK();
+    wasArmed = (uint8_t)(te->slot__ != SLOT_DISARMED);
+    if (wasArmed) {
+        unlink_(te);
+    }
+    link_(te, ticks);
+    SST_INT_UNLOCK();
+    return wasArmed;
+}
+/*..........................................................................*/
+/* NOTE: SST_tick() must be called from the tick ISR. The events due in this
+ * tick are collected under the interrupt lock, the periodic ones re-armed,
+ * and then posted with the lock released.
+ */
+void SST_tick(void) {
+    SST_tickAnnounce((uint16_t)1);
+}
+/*..........................................................................*/
+/* NOTE: SST_tickAnnounce() accounts for 'ticks' elapsed ticks at once, after
+ * a tickless sleep. Every skipped slot is still visited once, so the cost is
+ * O(ticks) plus the events in those slots; the sleep never passes the next
+ * expiry, so no event is posted late. A sleep that wakes late can cover
+ * several periods of a periodic event: its expiries coalesce into one post,
+ * like the ticks of a late tick ISR. An event is on a due list while its
+ * due__ is not NULL, until it is taken for posting.
+ */
+void SST_tickAnnounce(uint16_t ticks) {
+    SSTKernel *k = SST_kernel_;
+    SSTTimeEvt *due = DUE_END;
+    SSTTimeEvt *te;
+
+    SST_INT_LOCK();
+    k->tickCtr__ += ticks;
+    while (ticks-- != (uint16_t)0) {
+        k->cursor__ = (uint8_t)((k->cursor__ + 1U) & (SST_TEV_SLOTS - 1U));
+        te = k->wheel__[k->cursor__];
+        while (te != (SSTTimeEvt *)0) {
+            SSTTimeEvt *next = te->next__;
+            if (te->rounds__ != (uint16_t)0) {
+                --te->rounds__;                  /* not in this revolution */
+            }
+            else {
+                unlink_(te);
+                if (te->interval__ != (uint16_t)0) {
+                    link_(te, te->interval__);       /* periodic, re-arm */
+                }
+                if (te->due__ == (SSTTimeEvt *)0) {   /* not yet due here? */
+                    te->due__ = due;
+                    due = te;
+                }
+            }
+            te = next;
+        }
+    }
+    SST_INT_UNLOCK();
+
+    while (due != DUE_END) {
+        te = due;
+        due = te->due__;
+        te->due__ = (SSTTimeEvt *)0;      /* a nested tick may list it again */
+        SST_post(te->prio__, te->sig__, te->par__);
+    }
+}
+/*..........................................................................*/
+/* NOTE: SST_timeEvtNextExpiry() returns the number of ticks until the
+ * nearest armed time event expires, or 0 when no event is armed. It must be
+ * called with interrupts LOCKED. The slots are visited in the order of their
+ * distance from the cursor and the search stops as soon as no farther slot
+ * can hold an earlier event, so an event due in the current revolution
+ * costs one pass over the slots at most.
+ */
+uint16_t SST_timeEvtNextExpiry(void) {
+    uint32_t best = (uint32_t)0xFFFFFFFFU;
+    uint8_t dist;
+    for (dist = (uint8_t)1; dist <= (uint8_t)SST_TEV_SLOTS; ++dist) {
+        SSTTimeEvt const *te;
+        if ((uint32_t)dist >= best) {
+            break;                    /* the farther slots expire later */
+        }
+        te = SST_kernel_->wheel__[(SST_kernel_->cursor__ + dist)
+                                  & (SST_TEV_SLOTS - 1U)];
+        for (; te != (SSTTimeEvt *)0; te = te->next__) {
+            uint32_t t = (uint32_t)dist
+                         + ((uint32_t)te->rounds__ << SST_TEV_SLOTS_LOG2);
+            if (t < best) {
+                best = t;
+            }
+        }
+    }
+    if (best == (uint32_t)0xFFFFFFFFU) {
+        return (uint16_t)0;
+    }
+    return (best > (uint32_t)0xFFFFU) ? (uint16_t)0xFFFF : (uint16_t)best;
+}
+#ifdef SST_TICKLESS
+/*..........................................................................*/
+/* NOTE: SST_tickless() is meant to be called from SST_onIdle(). It computes
+ * the nearest timeout and hands it to the port's SST_onSleep(), which stops
+ * the periodic tick, waits in low power until the timeout or any other
+ * interrupt, and returns the whole ticks that really elapsed. They are then
+ * announced at once, so the kernel time stays correct after the wakeup.
+ */
+void SST_tickless(void) {
+    uint16_t elapsed;
+    SST_INT_LOCK();
+    elapsed = SST_onSleep(SST_timeEvtNextExpiry()); /* returns unlocked */
+    if (elapsed != (uint16_t)0) {
+        SST_tickAnnounce(elapsed);
+    }
+}
+#endif
+/*..........................................................................*/
+uint32_t SST_tickCount(void) {
+    uint32_t ctr;
+    SST_INT_LOCK();
+    ctr = SST_kernel_->tickCtr__;
+    SST_INT_UNLOCK();
+    return ctr;
+}
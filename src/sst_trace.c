@@ -0,0 +1,87 @@
+/*****************************************************************************
+* SST kernel trace
+*
+* This software may be distributed and modified under the terms of the GNU
+* General Public License version 2 (GPL) as published by the Free Software
+* Foundation and appearing in the file GPL.TXT included in the packaging of
+* this file. Please note that GPL Section 2[b] requires that all works based
+* on this software must also be made publicly available under the terms of
+* the GPL ("Copyleft").
+*****************************************************************************/
+#include "sst_port.h"
+
+#ifdef SST_TRACE
+
+/* Public-scope objects ----------------------------------------------------*/
+SSTTraceRec SST_traceBuf_[SST_TRACE_LEN];
+uint16_t SST_traceHead_;
+uint8_t SST_traceOn_ = (uint8_t)1;
+uint8_t SST_traceFull_;
+
+/*..........................................................................*/
+void SST_traceUser(uint8_t type, uint8_t a, uint8_t b) {
+    SST_INT_LOCK();
+    SST_TRACE_REC(type | SST_TRC_USER, a, b);
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+void SST_traceEnable(uint8_t on) {
+    SST_INT_LOCK();
+    SST_traceOn_ = on;
+    SST_INT_UNLOCK();
+}
+/*..........................................................................*/
+/* NOTE: SST_traceDump() stops the recording while the records are written,
+ * so the dump is consistent, and restores it afterwards. Once the ring was
+ * filled it holds SST_TRACE_LEN valid records, the oldest at the head slot,
+ * whatever the free-running head reads after wrapping. The dump is a
+ * 16-byte header, little-endian:
+ *   "SSTT", version (1), record size (8), number of records (uint16_t),
+ *   timestamp rate in Hz (uint32_t), SST_MAX_PRIO - 1, 3 reserved bytes,
+ * followed by the records, oldest first.
+ */
+void SST_traceDump(SSTTraceOut out) {
+    uint8_t hdr[16];
+    uint32_t hz = (uint32_t)SST_TRACE_TS_HZ;
+    uint16_t head;
+    uint16_t n;
+    uint16_t i;
+    uint8_t on;
+    uint8_t full;
+
+    SST_INT_LOCK();
+    on = SST_traceOn_;
+    SST_traceOn_ = (uint8_t)0;
+    head = SST_traceHead_;
+    full = SST_traceFull_;
+    SST_INT_UNLOCK();
+
+    n = full ? (uint16_t)SST_TRACE_LEN : head;
+    hdr[0] = 'S';
+    hdr[1] = 'S';
+    hdr[2] = 'T';
+    hdr[3] = 'T';
+    hdr[4] = (uint8_t)1;
+    hdr[5] = (uint8_t)sizeof(SSTTraceRec);
+    hdr[6] = (uint8_t)n;
+    hdr[7] = (uint8_t)(n >> 8);
+    hdr[8] = (uint8_t)hz;
+    hdr[9] = (uint8_t)(hz >> 8);
+    hdr[10] = (uint8_t)(hz >> 16);
+    hdr[11] = (uint8_t)(hz >> 24);
+    hdr[12] = (uint8_t)(SST_MAX_PRIO - 1);
+    hdr[13] = (uint8_t)0;
+    hdr[14] = (uint8_t)0;
+    hdr[15] = (uint8_t)0;
+    (*out)(hdr, (uint16_t)sizeof(hdr));
+    for (i = (uint16_t)(head - n); i != head; ++i) {
+        (*out)(&SST_traceBuf_[i & (SST_TRACE_LEN - 1U)],
+               (uint16_t)sizeof(SSTTraceRec));
+    }
+
+    SST_INT_LOCK();
+    SST_traceOn_ = on;
+    SST_INT_UNLOCK();
+}
+
+#endif                                                         /* SST_TRACE */
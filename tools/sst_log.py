@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#############################################################################
+# SST deferred log decoder
+#
+# This software may be distributed and modified under the terms of the GNU
+# General Public License version 2 (GPL) as published by the Free Software
+# Foundation and appearing in the file GPL.TXT included in the packaging of
+# this file. Please note that GPL Section 2[b] requires that all works based
+# on this software must also be made publicly available under the terms of
+# the GPL ("Copyleft").
+#############################################################################
+"""Format the raw records written by SST_logDrainRaw().
+
+    sst_log.py [-I include/sst_log.h] [-a app_log.h ...] log.bin
+
+The message table is read from the SST_LOG_MSGS(X_) list of sst_log.h and
+from the SST_LOG_APP_MSGS(X_) lists of the application headers, in the
+order the firmware numbers them. Use '-' to read the records from stdin,
+e.g. from the serial port.
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+LEVELS = {'SST_LOG_ERROR': 'E', 'SST_LOG_WARN': 'W', 'SST_LOG_INFO': 'I',
+          'SST_LOG_DEBUG': 'D'}
+ENTRY = re.compile(r'X_\(\s*(\w+)\s*,\s*(\w+)\s*,\s*("(?:[^"\\]|\\.)*")\s*\)')
+SPEC = re.compile(r'%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|l|ll)?([diuxXoc])')
+
+
+def read_table(path, macro):
+    """The (id, level, format) entries of '#define macro(X_)' in path."""
+    text = open(path).read().replace('\\\n', ' ')
+    m = re.search(r'#define\s+%s\(X_\)(.*)' % macro, text)
+    if not m:
+        return []
+    return [(i, LEVELS.get(l, '?'), bytes(f[1:-1], 'utf-8')
+             .decode('unicode_escape'))
+            for i, l, f in ENTRY.findall(m.group(1))]
+
+
+def format_rec(table, rec):
+    msg_id, _, a, b = struct.unpack('<BBHI', rec)
+    if msg_id >= len(table):
+        return '? unknown message %d (%d, %d)' % (msg_id, a, b)
+    name, level, fmt = table[msg_id]
+    args = (a, b)[:len(SPEC.findall(fmt))]
+    return '%s %s' % (level, SPEC.sub(lambda m: '%' + m.group(1)
+                                      .replace('u', 'd'), fmt) % args)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('log', help="raw records, '-' for stdin")
+    ap.add_argument('-I', '--header',
+                    default=os.path.join(here, '..', 'include', 'sst_log.h'))
+    ap.add_argument('-a', '--app', action='append', default=[],
+                    help='header defining SST_LOG_APP_MSGS(X_)')
+    args = ap.parse_args()
+
+    table = read_table(args.header, 'SST_LOG_MSGS')
+    for path in args.app:
+        table += read_table(path, 'SST_LOG_APP_MSGS')
+    f = sys.stdin.buffer if args.log == '-' else open(args.log, 'rb')
+    while True:
+        rec = f.read(8)
+        if len(rec) < 8:
+            break
+        print(format_rec(table, rec))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+#############################################################################
+# SST response-time analysis
+#
+# This software may be distributed and modified under the terms of the GNU
+# General Public License version 2 (GPL) as published by the Free Software
+# Foundation and appearing in the file GPL.TXT included in the packaging of
+# this file. Please note that GPL Section 2[b] requires that all works based
+# on this software must also be made publicly available under the terms of
+# the GPL ("Copyleft").
+#############################################################################
+"""Check that an SST task set is schedulable and generate its priorities.
+
+    sst_rta.py [-p keep|rm|dm] [-s stats.json] [-o sst_prio.h] tasks.json
+
+The task set is a JSON file, all times in microseconds:
+
+    {"lock": 20,                  longest interrupt-locked section, optional
+     "isrs":  [{"name": "TICK_ISR", "period": 100000, "wcet": 40,
+                "prio": 255}],
+     "tasks": [{"name": "TASK_A", "prio": 2, "period": 5000000,
+                "wcet": 900, "deadline": 5000000, "jitter": 0,
+                "cs": {"uart": 300}}],
+     "mutexes": {"uart": 7}}      fixed ceilings, optional
+
+'period' is the period or the minimum inter-arrival time of the task's
+events and 'wcet' the longest run to completion of one event. 'deadline'
+defaults to the period and 'jitter' (the release jitter) to 0. 'cs' lists
+the longest SST_mutexLock() section of the task per mutex; a mutex ceiling
+is the highest priority of its users unless set under "mutexes".
+
+The WCETs can be taken from the measured SST_getStats() maxRun values with
+-s, a JSON file {"hz": <SST_CYCLES_HZ>, "maxRun": {"<prio>": <cycles>}}
+keyed by the 'prio' of the task set; -m scales them by a safety margin.
+
+The analysis is the response-time analysis of fixed-priority preemptive
+scheduling with the stack resource policy, which is what SST implements:
+each event runs to completion, a task is preempted only by higher-priority
+tasks and by the ISRs, and it is blocked at most once, before it starts, by
+one lower-priority mutex section with a ceiling at or above its priority or
+by an interrupt-locked section. Deadlines may exceed periods; the events
+then queue up and the report gives the queue length the task needs. Tasks
+blocking in SST_wait() are outside of this model.
+"""
+import argparse
+import json
+import math
+import os
+import sys
+
+
+def load(path, stats, margin):
+    ts = json.load(open(path))
+    ts.setdefault('lock', 0)
+    ts.setdefault('isrs', [])
+    ts.setdefault('mutexes', {})
+    for t in ts['tasks']:
+        t.setdefault('deadline', t['period'])
+        t.setdefault('jitter', 0)
+        t.setdefault('cs', {})
+    if stats:
+        st = json.load(open(stats))
+        for t in ts['tasks']:
+            run = st['maxRun'].get(str(t.get('prio')))
+            if run is not None:
+                t['wcet'] = run * 1e6 / st['hz'] * margin
+    for n, isr in enumerate(ts['isrs']):
+        isr.setdefault('prio', 0xFF - n)
+        isr.setdefault('jitter', 0)
+    return ts
+
+
+def assign(tasks, policy, base):
+    """Priorities by rate (rm) or deadline (dm) monotonic order, or keep."""
+    if policy == 'keep':
+        return
+    key = 'period' if policy == 'rm' else 'deadline'
+    order = sorted(tasks, key=lambda t: -t[key])  # stable for equal keys
+    for n, t in enumerate(order):
+        t['prio'] = base + n
+
+
+def ceilings(ts):
+    ceil = {}
+    for t in ts['tasks']:
+        for m in t['cs']:
+            ceil[m] = max(ceil.get(m, 0), t['prio'])
+    ceil.update(ts['mutexes'])
+    return ceil
+
+
+def blocking(ts, ceil, t):
+    b = ts['lock']
+    for lo in ts['tasks']:
+        if lo['prio'] < t['prio']:
+            for m, cs in lo['cs'].items():
+                if ceil[m] >= t['prio']:
+                    b = max(b, cs)
+    return b
+
+
+def response(t, hp, b):
+    """The worst-case response time and the events queued, or None."""
+    if sum(j['wcet'] / j['period'] for j in hp + [t]) >= 1.0:
+        return None, None
+    r_max = 0
+    q = 0
+    while True:
+        w = b + (q + 1) * t['wcet'] + sum(j['wcet'] for j in hp)
+        while True:
+            nxt = b + (q + 1) * t['wcet'] + sum(
+                math.ceil((w + j['jitter']) / j['period']) * j['wcet']
+                for j in hp)
+            if nxt == w:
+                break
+            w = nxt
+            if w - q * t['period'] + t['jitter'] > t['deadline']:
+                return w - q * t['period'] + t['jitter'], q + 1
+        r_max = max(r_max, w - q * t['period'] + t['jitter'])
+        if r_max > t['deadline']:
+            return r_max, q + 1
+        if w <= (q + 1) * t['period'] - t['jitter']:  # busy period ends
+            return r_max, q + 1
+        q += 1
+
+
+def analyse(ts):
+    ceil = ceilings(ts)
+    rows = []
+    for t in sorted(ts['tasks'], key=lambda t: -t['prio']):
+        hp = [j for j in ts['tasks'] if j['prio'] > t['prio']] + ts['isrs']
+        b = blocking(ts, ceil, t)
+        r, queue = response(t, hp, b)
+        rows.append((t, b, r, queue))
+    return ceil, rows
+
+
+def report(ts, rows, out):
+    u = sum(j['wcet'] / j['period'] for j in ts['tasks'] + ts['isrs'])
+    out.write('utilization %.1f%%, interrupt lock %g us\n'
+              % (100.0 * u, ts['lock']))
+    out.write('%4s  %-16s %10s %10s %8s %8s %10s %6s\n'
+              % ('prio', 'task', 'period', 'deadline', 'wcet', 'block',
+                 'response', 'queue'))
+    ok = True
+    for t, b, r, queue in rows:
+        miss = r is None or r > t['deadline']
+        ok = ok and not miss
+        out.write('%4d  %-16s %10g %10g %8.1f %8.1f %10s %6s%s\n'
+                  % (t['prio'], t['name'], t['period'], t['deadline'],
+                     t['wcet'], b, '-' if r is None else '%.1f' % r,
+                     '-' if queue is None else queue,
+                     '  MISS' if miss else ''))
+    out.write('schedulable\n' if ok else 'NOT schedulable\n')
+    return ok
+
+
+def header(ts, ceil, src, path):
+    guard = os.path.splitext(os.path.basename(path))[0] + '_h'
+    lines = ['/* generated by tools/sst_rta.py from %s, do not edit */'
+             % os.path.basename(src),
+             '#ifndef %s' % guard, '#define %s' % guard, '',
+             'enum SSTPriorities {     '
+             '/* the SST priorities don\'t need to be consecutive */',
+             '    /* task priorities... */']
+    for t in sorted(ts['tasks'], key=lambda t: t['prio']):
+        lines.append('    %s_PRIO = %d,' % (t['name'], t['prio']))
+    if ceil:
+        lines += ['', '    /* mutex priority ceilings... */']
+        for m in sorted(ceil, key=lambda m: ceil[m]):
+            lines.append('    %s_CEILING = %d,' % (m.upper(), ceil[m]))
+    lines += ['', '    /* ISR priorities... */']
+    for isr in sorted(ts['isrs'], key=lambda i: i['prio']):
+        lines.append('    %s_PRIO = 0x%02X,' % (isr['name'], isr['prio']))
+    lines[-1] = lines[-1].rstrip(',')
+    lines += ['};', '', '#endif%s/* %s */'
+              % (' ' * max(1, 66 - len(guard)), guard), '']
+    open(path, 'w').write('\n'.join(lines))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('tasks', help='task set, JSON')
+    ap.add_argument('-p', '--policy', choices=('keep', 'rm', 'dm'),
+                    default='keep', help='priority assignment: keep the '
+                    'given priorities, rate or deadline monotonic')
+    ap.add_argument('-b', '--base', type=int, default=1,
+                    help='lowest priority assigned by rm/dm')
+    ap.add_argument('-s', '--stats', help='measured maxRun values, JSON')
+    ap.add_argument('-m', '--margin', type=float, default=1.0,
+                    help='factor applied to the measured maxRun values')
+    ap.add_argument('-M', '--max-prio', type=int, default=32,
+                    help='SST_MAX_PRIO of the port')
+    ap.add_argument('-o', '--output', help='priority header to generate')
+    args = ap.parse_args()
+
+    ts = load(args.tasks, args.stats, args.margin)
+    assign(ts['tasks'], args.policy, args.base)
+    prios = [t['prio'] for t in ts['tasks']]
+    if len(set(prios)) != len(prios) or \
+            not all(1 <= p <= args.max_prio for p in prios):
+        sys.exit('task priorities must be unique and in 1..%d'
+                 % args.max_prio)
+    ceil, rows = analyse(ts)
+    ok = report(ts, rows, sys.stdout)
+    if args.output:
+        header(ts, ceil, args.tasks, args.output)
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+#############################################################################
+# SST kernel RAM report
+#
+# This software may be distributed and modified under the terms of the GNU
+# General Public License version 2 (GPL) as published by the Free Software
+# Foundation and appearing in the file GPL.TXT included in the packaging of
+# this file. Please note that GPL Section 2[b] requires that all works based
+# on this software must also be made publicly available under the terms of
+# the GPL ("Copyleft").
+#############################################################################
+"""Compare the kernel RAM of the dense and the sparse (SST_MAX_TASKS) task
+tables.
+
+    sst_size.py [-t 5] [-p 8,16,32,64,128,256] [--cc gcc] [-- cflags...]
+
+src/sst.c is compiled for every SST_MAX_PRIO with the host port headers,
+once with the table indexed by priority and once with SST_MAX_TASKS, and
+the size of the kernel context SST_kernel0_, which holds the task table,
+is read with nm. Pass -m32 (or a cross compiler with --cc and its include
+paths) to see a 32-bit target such as the ESP8266; the default is the
+host's pointer size.
+"""
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+TABLE = ('SST_kernel0_',)
+
+
+def table_bytes(cc, cflags, defines):
+    here = os.path.dirname(os.path.abspath(__file__))
+    root = os.path.join(here, '..')
+    with tempfile.TemporaryDirectory() as tmp:
+        obj = os.path.join(tmp, 'sst.o')
+        subprocess.check_call(
+            [cc, '-c', '-O2', '-std=gnu99', '-o', obj,
+             '-I' + os.path.join(root, 'posix'),
+             '-I' + os.path.join(root, 'include')]
+            + ['-D%s' % d for d in defines] + cflags
+            + [os.path.join(root, 'src', 'sst.c')])
+        out = subprocess.check_output(['nm', '-S', obj]).decode()
+    total = 0
+    for line in out.splitlines():
+        f = line.split()
+        if len(f) == 4 and f[3] in TABLE:
+            total += int(f[1], 16)
+    return total
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('-t', '--tasks', type=int, default=5,
+                    help='SST_MAX_TASKS of the sparse table')
+    ap.add_argument('-p', '--prios', default='8,16,32,64,128,256',
+                    help='SST_MAX_PRIO values to compare')
+    ap.add_argument('--cc', default='gcc')
+    ap.add_argument('cflags', nargs='*', help='extra compiler flags')
+    args = ap.parse_args()
+
+    print('kernel RAM in bytes, SST_MAX_TASKS = %d' % args.tasks)
+    print('%12s %8s %8s %8s' % ('SST_MAX_PRIO', 'dense', 'sparse', 'saved'))
+    for prio in args.prios.split(','):
+        base = ['SST_MAX_PRIO=%s' % prio]
+        dense = table_bytes(args.cc, args.cflags, base)
+        sparse = table_bytes(args.cc, args.cflags,
+                             base + ['SST_MAX_TASKS=%d' % args.tasks])
+        print('%12s %8d %8d %7.0f%%'
+              % (prio, dense, sparse, 100.0 * (dense - sparse) / dense))
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+#############################################################################
+# SST kernel trace decoder
+#
+# This software may be distributed and modified under the terms of the GNU
+# General Public License version 2 (GPL) as published by the Free Software
+# Foundation and appearing in the file GPL.TXT included in the packaging of
+# this file. Please note that GPL Section 2[b] requires that all works based
+# on this software must also be made publicly available under the terms of
+# the GPL ("Copyleft").
+#############################################################################
+"""Convert an SST_traceDump() dump into Chrome trace / Perfetto JSON.
+
+    sst_trace.py dump.bin [-o trace.json] [--text]
+
+Open the JSON in chrome://tracing or https://ui.perfetto.dev. Every task
+priority and every ISR priority is a track; task runs and ISRs are slices,
+posts, mutexes and semaphores are instant events. The record layout is the
+one of include/sst_trace.h.
+"""
+import argparse
+import json
+import struct
+import sys
+
+POST, POST_FAIL, DISPATCH, PREEMPT, DONE, ISR_ENTRY, ISR_EXIT, \
+    MUTEX_LOCK, MUTEX_UNLOCK, SEM_BLOCK, SEM_WAKE = range(1, 12)
+USER = 0x80
+
+NAMES = {
+    POST: 'post', POST_FAIL: 'post failed', DISPATCH: 'dispatch',
+    PREEMPT: 'preempt', DONE: 'done', ISR_ENTRY: 'isr entry',
+    ISR_EXIT: 'isr exit', MUTEX_LOCK: 'mutex lock',
+    MUTEX_UNLOCK: 'mutex unlock', SEM_BLOCK: 'sem block',
+    SEM_WAKE: 'sem wake',
+}
+
+
+def read_dump(data):
+    """Return (timestamp rate in Hz, max task priority, records)."""
+    if len(data) < 16 or data[0:4] != b'SSTT':
+        raise ValueError('not an SST trace dump')
+    version, rec_size, n, hz, max_prio = struct.unpack_from('<BBHIB', data, 4)
+    if version != 1 or rec_size != 8:
+        raise ValueError('unsupported dump version %d' % version)
+    max_prio += 1                      # stored as SST_MAX_PRIO - 1 (uint8)
+    recs = []
+    ts_hi = 0
+    last = None
+    for i in range(n):
+        ts, typ, prio, a, b = struct.unpack_from('<IBBBB', data, 16 + 8 * i)
+        if last is not None and ts < last:
+            ts_hi += 1 << 32                   # the 32-bit counter wrapped
+        last = ts
+        recs.append((ts + ts_hi, typ, prio, a, b))
+    return hz, max_prio, recs
+
+
+def track(prio, max_prio):
+    return ('task %d' % prio) if 0 < prio <= max_prio else ('isr %d' % prio)
+
+
+def to_chrome(hz, max_prio, recs):
+    """Chrome trace events, timestamps in microseconds from the first."""
+    t0 = recs[0][0] if recs else 0
+    events = []
+    open_slices = {}                      # track -> number of open slices
+    tids = set()
+
+    def us(ts):
+        return (ts - t0) * 1e6 / hz
+
+    def slice_(ph, name, tid, ts, args=None):
+        if ph == 'E':
+            if open_slices.get(tid, 0) == 0:
+                return                   # began before the oldest record
+            open_slices[tid] -= 1
+        else:
+            open_slices[tid] = open_slices.get(tid, 0) + 1
+        ev = {'ph': ph, 'name': name, 'pid': 0, 'tid': tid, 'ts': us(ts)}
+        if args:
+            ev['args'] = args
+        events.append(ev)
+        tids.add(tid)
+
+    def instant(name, tid, ts, args):
+        events.append({'ph': 'i', 's': 't', 'name': name, 'pid': 0,
+                       'tid': tid, 'ts': us(ts), 'args': args})
+        tids.add(tid)
+
+    for ts, typ, prio, a, b in recs:
+        if typ in (DISPATCH, PREEMPT):
+            if typ == PREEMPT:
+                instant('preempted', prio, ts, {'by': a})
+            slice_('B', track(a, max_prio), a, ts, {'sig': b})
+        elif typ == DONE:
+            slice_('E', track(a, max_prio), a, ts)
+        elif typ == ISR_ENTRY:
+            slice_('B', track(a, max_prio), a, ts, {'interrupted': b})
+        elif typ == ISR_EXIT:
+            slice_('E', track(a, max_prio), a, ts)
+        elif typ in (POST, POST_FAIL):
+            instant(NAMES[typ], prio, ts, {'to': a, 'sig': b})
+        elif typ == MUTEX_LOCK:
+            instant('mutex lock', prio, ts, {'ceiling': a, 'from': b})
+        elif typ == MUTEX_UNLOCK:
+            instant('mutex unlock', prio, ts, {'to': a})
+        elif typ == SEM_BLOCK:
+            instant('sem block', a, ts, {'count': b})
+        elif typ == SEM_WAKE:
+            instant('sem wake', a, ts, {'by': prio})
+        elif typ & USER:
+            instant('user %d' % (typ & ~USER), prio, ts, {'a': a, 'b': b})
+
+    for tid in sorted(tids):
+        name = 'idle' if tid == 0 else track(tid, max_prio)
+        events.append({'ph': 'M', 'name': 'thread_name', 'pid': 0,
+                       'tid': tid, 'args': {'name': name}})
+        events.append({'ph': 'M', 'name': 'thread_sort_index', 'pid': 0,
+                       'tid': tid, 'args': {'sort_index': -tid}})
+    return {'traceEvents': events, 'displayTimeUnit': 'ns'}
+
+
+def to_text(hz, recs, out):
+    t0 = recs[0][0] if recs else 0
+    for ts, typ, prio, a, b in recs:
+        name = NAMES.get(typ, 'user %d' % (typ & ~USER))
+        out.write('%12.3f us  prio %3d  %-13s %3d %3d\n'
+                  % ((ts - t0) * 1e6 / hz, prio, name, a, b))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument('dump')
+    ap.add_argument('-o', '--output', help='JSON file (default stdout)')
+    ap.add_argument('--text', action='store_true',
+                    help='list the records instead of writing JSON')
+    args = ap.parse_args()
+    with open(args.dump, 'rb') as f:
+        hz, max_prio, recs = read_dump(f.read())
+    out = open(args.output, 'w') if args.output else sys.stdout
+    if args.text:
+        to_text(hz, recs, out)
+    else:
+        json.dump(to_chrome(hz, max_prio, recs), out)
+        out.write('\n')
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == '__main__':
+    main()